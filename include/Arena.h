@@ -0,0 +1,60 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <vector>
+
+#define ARENA_CACHE_LINE  64
+#define ARENA_CHUNK_SIZE  65536
+
+/**
+ * Arena
+ *
+ * Bump allocator of cache-line-aligned blocks
+ * Blocks are never freed one by one, all memory is released with the arena,
+ * so owner should reuse blocks instead of allocating them again
+ *
+ * Arena is not thread-safe, each thread (solver) should have it's own
+ *
+ */
+class Arena
+{
+public:
+    Arena(size_t chunkSize = ARENA_CHUNK_SIZE);
+    void* allocate(size_t size);        // get cache-line-aligned block
+    ~Arena();
+private:
+    Arena(const Arena &arena);          // not copyable
+    Arena& operator = (const Arena &arena);
+
+    size_t _chunkSize;                  // default size of chunk taken from system
+    size_t _used;                       // used bytes in a current chunk
+    size_t _capacity;                   // size of current chunk
+    std::vector<char*> _chunks;         // chunks taken from system (last one is current)
+};
+
+#endif // ARENA_H
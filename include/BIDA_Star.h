@@ -0,0 +1,99 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BIDA_STAR_H
+#define BIDA_STAR_H
+
+#include "Solver.h"
+#include <stdint.h>
+#include <vector>
+
+#define BIDA_MEMORY_DEFAULT 64          // memory for states of goal perimeter in MB
+#define BIDA_DEPTH_UNKNOWN  0xFF        // state isn't in perimeter (or it's level didn't fit into memory)
+
+/**
+ * Bidirectional IDA* (perimeter search)
+ *
+ * Backward breadth-first search from a goal stores all states up to perimeter depth in a hash of bounded size,
+ * then forward IDA* search stops as soon as it meets a state of perimeter
+ *
+ */
+class BIDA_Star : public Solver
+{
+public:
+    BIDA_Star(Board &board);
+    void setMemoryLimit(int mb);        // memory for states of goal perimeter in MB
+    int solve();
+    ~BIDA_Star();
+private:
+    typedef int (BIDA_Star::*Iteration)(int F);
+
+    /**
+     * Frame of DFS stack (one per depth)
+     *
+     */
+    struct Frame
+    {
+        int moves[NEIGHBOURS_CNT_MAX];  // positions where empty cell can be moved
+        int movesCnt;
+        int next;                       // index of next move to check
+        int blank;                      // flat position of empty cell
+        int prev;                       // flat position of empty cell at previous depth (-1 at the root)
+        int fsm;                        // state of move automaton (0 at the root, see MoveAutomaton)
+        int hNbr;                       // heuristic saved by step forward (see Solver::__stepForward)
+        int hZero;
+        int hSum;
+    };
+
+    Frame *_stack;                      // DFS stack, depth => frame (preallocated from arena)
+    size_t _memoryLimit;                // memory for states of goal perimeter in bytes
+    std::vector<uint64_t> _keys;        // open addressing hash of packed states (0 is empty slot)
+    std::vector<unsigned char> _depths; // slot => count of moves from a goal
+    uint64_t _mask;                     // count of slots - 1
+    int _perimeter;                     // all states up to this count of moves from a goal are in hash
+    size_t _perimeterCnt;               // count of states in perimeter
+    std::vector<int> _parity;           // flat position of empty cell => parity of count of moves to a goal
+
+    Iteration __kernel();               // choose search kernel for board dimension
+    bool __buildPerimeter();            // backward breadth-first search from a goal
+    uint64_t __hash(uint64_t state);    // slot of packed state
+    int __find(uint64_t state);         // count of moves from a goal (BIDA_DEPTH_UNKNOWN if state isn't in perimeter)
+    bool __insert(uint64_t state,
+                  int depth);           // add state if it's new
+    void __descend(uint64_t state,
+                   int G,
+                   int depth);          // append moves from perimeter state to a goal (depths G+1..G+depth)
+
+    template <int Width = 0, int Height = 0>
+    int __iteration(int F);             // one cost-bounded search from the root
+
+    template <int Width = 0, int Height = 0>
+    int __DFS(int F,
+              int G,
+              int prev);                // depth-first search with cost limit
+};
+
+#include "BIDA_Star.hpp"
+
+#endif // BIDA_STAR_H
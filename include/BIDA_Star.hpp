@@ -0,0 +1,220 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <limits>
+
+/**
+ * BIDA_Star::__hash
+ *
+ * Slot of packed state (bits of state are mixed, so neighbour states are spread over hash)
+ *
+ */
+inline uint64_t BIDA_Star::__hash(uint64_t state)
+{
+    state ^= state >> 33;
+    state *= 0xff51afd7ed558ccdULL;
+    state ^= state >> 33;
+    return state & _mask;
+}
+
+/**
+ * BIDA_Star::__find
+ *
+ * Return count of moves from a goal to packed state,
+ * BIDA_DEPTH_UNKNOWN if state isn't in perimeter
+ *
+ */
+inline int BIDA_Star::__find(uint64_t state)
+{
+    for ( uint64_t slot = __hash(state); _keys[slot]; slot = (slot + 1) & _mask )
+    {
+        if ( _keys[slot] == state )
+        {
+            return _depths[slot];
+        }
+    }
+    return BIDA_DEPTH_UNKNOWN;
+}
+
+/**
+ * BIDA_Star::__insert
+ *
+ * Add packed state at count of moves from a goal
+ *
+ * Return false if state is already in hash
+ *
+ */
+inline bool BIDA_Star::__insert(uint64_t state, int depth)
+{
+    uint64_t slot = __hash(state);
+    for ( ; _keys[slot]; slot = (slot + 1) & _mask )
+    {
+        if ( _keys[slot] == state )
+        {
+            return false;
+        }
+    }
+    _keys[slot] = state;
+    _depths[slot] = depth;
+    return true;
+}
+
+/**
+ * BIDA_Star::__iteration
+ *
+ */
+template <int Width, int Height>
+inline int BIDA_Star::__iteration(int F)
+{
+    return __DFS<Width, Height>(F, 1, -1);
+}
+
+/**
+ * BIDA_Star::__DFS
+ *
+ * Depth-first search (DFS) algorithm with cost limits (see IDA_Star::__DFS)
+ * F = total cost
+ * G = current cost
+ * prev = flat position of empty cell before previous step (-1 at the root)
+ *
+ * If heuristic of state doesn't exceed perimeter depth, it's looked up in perimeter:
+ * state of perimeter has exact cost and it's remaining moves are taken from perimeter,
+ * other states are at least one move farther than perimeter depth
+ * (count of moves has the same parity as distance of empty cell to it's goal position)
+ * So forward search never goes deeper than F - perimeter depth
+ *
+ * Return minimal found cost (0 if solution was found)
+ *
+ */
+template <int Width, int Height>
+inline int BIDA_Star::__DFS(int F, int G, int prev)
+{
+    int min = std::numeric_limits<int>::max();
+    int root = G;
+    Frame *frame = &_stack[G];
+    frame->blank = _board.getBlank();
+    frame->prev = prev;
+    frame->fsm = 0;
+    frame->next = 0;
+    frame->movesCnt = _board.getMoves<Width, Height>(frame->moves);
+
+    for ( ;; )
+    {
+        if ( frame->next == frame->movesCnt )
+        {
+
+            // all neighbours were checked, go back to previous depth
+            if ( G == root )
+            {
+                break;
+            }
+            G--;
+            frame--;
+            __stepBack<Width, Height>(frame->blank, _path[G], frame->hNbr, frame->hZero, frame->hSum);
+
+            if ( ! min )
+            {
+
+                // solution was found, skip other neighbours
+                frame->next = frame->movesCnt;
+            }
+            continue;
+        }
+
+        int pos = frame->moves[frame->next++];
+
+        if ( pos == frame->prev )
+        {
+            continue;
+        }
+
+        int state = 0;
+        if ( _automaton )
+        {
+            int direction = MoveAutomaton::getDirection(Width ? Width : _board.getWidth(), frame->blank, pos);
+            state = _automaton->next(frame->fsm, direction);
+            if ( state == MOVE_AUTOMATON_PRUNED )
+            {
+
+                // the same state is reached by a preferred sequence of moves
+                continue;
+            }
+        }
+
+        int nbr = _board.getCell<Width, Height>(pos);
+        int H = __stepForward<Width, Height>(pos, nbr, frame->hNbr, frame->hZero, frame->hSum);
+        int depth = BIDA_DEPTH_UNKNOWN;
+        if ( H <= _perimeter )
+        {
+            depth = __find(_board.getPacked());
+            if ( depth == BIDA_DEPTH_UNKNOWN )
+            {
+                H = _perimeter + 1 + ((_perimeter + 1 + _parity[pos]) & 1);
+            }
+            else
+            {
+                H = depth;
+            }
+        }
+        int f = G + H;
+
+        if ( f > F )
+        {
+
+            // step back, this is wrong way, but other neighbours still should be checked
+            __stepBack<Width, Height>(frame->blank, nbr, frame->hNbr, frame->hZero, frame->hSum);
+
+            if ( f < min )
+            {
+                min = f;
+            }
+            continue;
+        }
+
+        _path[G] = nbr;
+
+        if ( depth != BIDA_DEPTH_UNKNOWN )
+        {
+
+            // search fronts met
+            __descend(_board.getPacked(), G, depth);
+            __saveSolution(G + depth);
+            __stepBack<Width, Height>(frame->blank, nbr, frame->hNbr, frame->hZero, frame->hSum);
+            min = 0;
+            frame->next = frame->movesCnt;
+            continue;
+        }
+
+        // go to next depth
+        G++;
+        frame++;
+        frame->blank = pos;
+        frame->prev = (frame - 1)->blank;
+        frame->fsm = state;
+        frame->next = 0;
+        frame->movesCnt = _board.getMoves<Width, Height>(frame->moves);
+    }
+
+    return min;
+}
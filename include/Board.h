@@ -25,26 +25,41 @@
 #ifndef BOARD_H
 #define BOARD_H
 
+#include "BoardGeometry.h"
 #include "Logger.h"
+#include <stdint.h>
 #include <new>
 #include <limits>
 #include <map>
 #include <string>
 #include <time.h>
 #include <vector>
-#include <boost/algorithm/string/split.hpp>
-#include <boost/algorithm/string/classification.hpp>
-#include <boost/lexical_cast.hpp>
+#include <boost/thread/mutex.hpp>
 
 #define BOARD_WIDTH  3
 #define BOARD_HEIGHT 3
 
-#define NEIGHBOURS_CNT_MAX 4
+#define PACKED_SIZE_MAX  16             // boards up to 16 cells are packed into one 64-bit word
+#define PACKED_CELL_BITS 4
+#define PACKED_CELL_MASK 0xFULL
+
+#define BOARD_CELLS_MAX 1024            // max count of cells in a board parsed from JSON array
 
 #define ARRAY_START_CHAR         '['
 #define ARRAY_END_CHAR           ']'
 #define ARRAY_ELEM_SPLITTER_CHAR ','
 
+/**
+ * Moves of empty cell for one board geometry (width x height)
+ * Built once and shared by all boards with the same dimension
+ *
+ */
+struct MoveTable
+{
+    std::vector<int> moves;             // flat position * NEIGHBOURS_CNT_MAX + i => i-th position where empty cell can be moved
+    std::vector<int> movesCnt;          // flat position => count of moves
+};
+
 class Board
 {
 public:
@@ -52,7 +67,9 @@ public:
     Board(int width,
           int height);
     Board(const std::string json);
-    Board(const Board &board);
+    Board(const int * const cells,
+          int width,
+          int height);                  // board from validated flat cells (see Board::parse)
     int getWidth();
     int getHeight();
     int getSize();
@@ -60,29 +77,50 @@ public:
     void getValueXY(int value, int &x, int &y);
     void swap(int a, int b);
     int getNeigbours(int value, int * const nbrs);
+    int getBlank();                     // position of empty cell
+    uint64_t getPacked();               // packed cells (boards up to PACKED_SIZE_MAX cells)
+    template <int Width = 0, int Height = 0>
+    int getCell(int pos);               // value of cell at flat position
+    template <int Width = 0, int Height = 0>
+    int getMoves(int * const moves);    // positions where empty cell can be moved
+    template <int Width = 0, int Height = 0>
+    void moveBlank(int pos);            // swap empty cell with cell at flat position
     void print();
     std::string toString();             // pack board into JSON array format
     bool isNotNull();                   // check if board was created
     void dumpIndexes();                 // print all indexes into log
-    ~Board();
+    static const MoveTable* getMoveTable(int width,
+                                         int height); // get (build if needed) moves of empty cell for geometry
+    static int parse(const char *json,
+                     int length,
+                     int * const cells,
+                     int &width,
+                     int &height,
+                     std::string *error = NULL); // parse one JSON array into flat cells
+    static bool check(const int * const cells,
+                      int width,
+                      int height,
+                      std::string *error = NULL); // check if flat cells are a board (see Board::parse)
+    static int parseAll(const char *json,
+                        int length,
+                        std::vector<Board> &boards,
+                        std::vector<std::string> *errors = NULL); // parse many JSON arrays from one buffer
 private:
     int _width;
     int _height;
-    int _size;                          // flat board size (width * height)
-    int **_board;
-    int **_bIndex;                      // board Index
-    int ***_nIndex;                     // neighbour Index
+    int _size;                          // flat board size (width * height), 0 if board wasn't created
+    int _blank;                         // flat position of empty cell
+    uint64_t _cells;                    // packed cells, 4 bits per cell (boards up to PACKED_SIZE_MAX cells)
+    std::vector<int> _flatCells;        // flat cells (boards greater than PACKED_SIZE_MAX cells)
+    const MoveTable *_moveTable;        // moves of empty cell, shared between boards
+
 
     void __createRandom();              // create random board
-    void __init();                      // init all indexes
-    void __destroy();                   // destroy board and indexes
-    void __bIndex();                    // build board Index
-    void __nIndex();                    // build neighbour Index
-    int** __parse(std::string json,
-                  int &width,
-                  int &height);         // parse string like JSON array into board format
+    void __setCell(int pos,
+                   int value);          // put value into cell at flat position
+    int __findCell(int value);          // find flat position of value
+    void __load(const int * const cells); // fill board with flat cells
 };
-
 #include "Board.hpp"
 
 #endif // BOARD_H
@@ -31,353 +31,182 @@
  */
 inline void Board::__createRandom()
 {
-    __destroy();
+    _moveTable = getMoveTable(_width, _height);
     srand ( time(NULL) );
     int size = _size;
     int boardArray[size];
     for ( int x = 0; x < _size; x++ )
         boardArray[x] = x;
-    _board = new int *[_height];
-    for ( int x = 0; x < _height; x++ )
-        _board[x] = new int[_width];
-    for ( int x = 0; x < _height; x++ )
-        for ( int y = 0; y < _width; y++ )
-        {
-            int rid = rand() % size;
-            _board[x][y] = boardArray[rid];
-            boardArray[rid] = boardArray[--size];
-        }
-    __init();
+    _cells = 0;
+    if ( _size > PACKED_SIZE_MAX )
+    {
+        _flatCells.assign(_size, 0);
+    }
+    for ( int pos = 0; pos < _size; pos++ )
+    {
+        int rid = rand() % size;
+        __setCell(pos, boardArray[rid]);
+        boardArray[rid] = boardArray[--size];
+    }
 }
 
 /**
- * Board::__init
+ * Board::__setCell
  *
- * Init board internal data
+ * Put value into cell at flat position
+ * Cell is expected to be empty (just created) or overwritten as a whole
  *
  */
-inline void Board::__init()
+inline void Board::__setCell(int pos, int value)
 {
-    __bIndex();
-    __nIndex();
+    if ( _size <= PACKED_SIZE_MAX )
+    {
+        int shift = pos * PACKED_CELL_BITS;
+        _cells = (_cells & ~(PACKED_CELL_MASK << shift)) | ((uint64_t)value << shift);
+    }
+    else
+    {
+        _flatCells[pos] = value;
+    }
+    if ( ! value )
+    {
+        _blank = pos;
+    }
 }
 
 /**
- * Board::__destroy
+ * Board::__load
  *
- * Cleanup board data
+ * Fill board with flat cells
+ * _width, _height and _size should be set before call
  *
  */
-inline void Board::__destroy()
+inline void Board::__load(const int * const cells)
 {
-    if ( _board )
+    _moveTable = getMoveTable(_width, _height);
+    _cells = 0;
+    if ( _size > PACKED_SIZE_MAX )
     {
-
-        // cleanup board
-        for ( int x = 0; x < _height; x++ )
-            delete [] _board[x];
-        delete [] _board;
-        _board = NULL;
-
-        // cleanup board index
-        for ( int x = 0; x < _size; x++ )
-            delete [] _bIndex[x];
-        delete [] _bIndex;
-
-        // cleanup neighbour index
-        for ( int x = 0; x < _size; x++ )
-            delete [] _nIndex[x];
-        delete [] _nIndex;
+        _flatCells.assign(_size, 0);
+    }
+    for ( int pos = 0; pos < _size; pos++ )
+    {
+        __setCell(pos, cells[pos]);
     }
 }
 
 /**
- * Board::__bIndex
- *
- * Create index of cells coordinates
- *
- * Example:
+ * Board::__findCell
  *
- * Board -> 4 1 6
- *          2 7 5
- *          0 8 3
- * bIndex[0] = [2,0]
- * ...
- * bIndex[8] = [2,1]
+ * Find flat position of value
+ * Linear scan, so it shouldn't be used in a search loop
  *
  */
-inline void Board::__bIndex()
+inline int Board::__findCell(int value)
 {
-    _bIndex = new int *[_size];
-    for ( int x = 0; x < _size; x++ )
-        _bIndex[x] = new int[2];
-    for ( int x = 0; x < _height; x++ )
-        for ( int y = 0; y < _width; y++ )
+    if ( ! value )
+    {
+        return _blank;
+    }
+    for ( int pos = 0; pos < _size; pos++ )
+    {
+        if ( getCell(pos) == value )
         {
-            _bIndex[_board[x][y]][0] = x;
-            _bIndex[_board[x][y]][1] = y;
+            return pos;
         }
+    }
+    return -1;
 }
 
 /**
- * Board::__nIndex
+ * Board::getBlank
  *
- * Create index of neighbour cells
+ * Return flat position of empty cell
  *
- * Example:
+ */
+inline int Board::getBlank()
+{
+    return _blank;
+}
+
+/**
+ * Board::getPacked
  *
- * Board -> 1 2 3
- *          4 5 6
- *          7 0 8
- * 0 has address 0x100
- * 8 has address 0x200
- * 7 has address 0x300
- * 5 has address 0x400
- * 6 has address 0x500
- * nIndex[0] = [0x300, 0x400, 0x200]
- * ...
- * nIndex[8] = [0x100, 0x500]
+ * Return packed cells, 4 bits per cell (0 for boards greater than PACKED_SIZE_MAX cells)
  *
  */
-inline void Board::__nIndex()
+inline uint64_t Board::getPacked()
 {
-    _nIndex = new int **[_size];
-    for ( int x = 0; x < _height; x++ )
-        for ( int y = 0; y < _width; y++ )
-        {
-            int cell = _board[x][y];
-            _nIndex[cell] = new int *[NEIGHBOURS_CNT_MAX];
-            for ( int i = 0; i < NEIGHBOURS_CNT_MAX; i++ )
-                _nIndex[cell][i] = 0;
-            int cnt = 0;
-            int yLeft = y - 1;
-            if ( yLeft >= 0 )
-                _nIndex[cell][cnt++] = &_board[x][yLeft];
-            int xUp = x - 1;
-            if ( xUp >= 0 )
-                _nIndex[cell][cnt++] = &_board[xUp][y];
-            int yRight = y + 1;
-            if ( yRight < _width )
-                _nIndex[cell][cnt++] = &_board[x][yRight];
-            int xDown = x + 1;
-            if ( xDown < _height )
-                _nIndex[cell][cnt] = &_board[xDown][y];
-        }
+    return _cells;
 }
 
 /**
- * Board::__parse
+ * Board::getCell
  *
- * Parse string like "[[1,2,3],[4,5,6],[7,8,0]]" and return new board
+ * Return value of cell at flat position
+ * Width and Height are board dimensions known while compiling (0 if they are known only at runtime)
+ * This method is unsave!!!
+ * Because of Solver class performance it doesn't check input params and board state
  *
  */
-inline int** Board::__parse(std::string json, int &width, int &height)
+template <int Width, int Height>
+inline int Board::getCell(int pos)
 {
-    int length = json.length();
-    if ( ! length )
+    if ( Width ? Width * Height <= PACKED_SIZE_MAX : _size <= PACKED_SIZE_MAX )
     {
-        Logger::getInstance().errorAt("Board::__parse")
-        .explain("param is null")
-        .endl();
-        return NULL;
+        return (_cells >> (pos * PACKED_CELL_BITS)) & PACKED_CELL_MASK;
     }
+    return _flatCells[pos];
+}
 
-    /* step 1
-     * collect positions for opening and closing array tokens
-     */
-    std::vector<int> openTokens;
-    std::vector<int> closeTokens;
-
-    for (int i = 1; i< length - 1; i++)
-    {
-        if ( json[i] == ARRAY_START_CHAR )
-        {
-            openTokens.push_back(i);
-        }
-        else if ( json[i] == ARRAY_END_CHAR )
-        {
-            closeTokens.push_back(i);
-        }
-    }
-    if ( openTokens.size() != closeTokens.size() )
-    {
-        Logger::getInstance().errorAt("Board::__parse")
-        .explain("bad tokens ")
-        .append(ARRAY_START_CHAR)
-        .append(ARRAY_END_CHAR)
-        .append(" balance")
-        .endl();
-        return NULL;
-    }
-
-    /* step 2
-     * build map with
-     * opening token position => closing token position
-     */
-    std::map<int, int> tokenMap;
-    int prevClosePos = std::numeric_limits<int>::max();
-    for (int i = openTokens.size() - 1; i >= 0; i--)
-    {
-        int openPos = openTokens[i];
-        unsigned int j = 0;
-        while ( j < closeTokens.size() && closeTokens[j] <= openPos )
-        {
-            j++;
-        }
-        if ( closeTokens[j] > openPos )
-        {
-            if ( closeTokens[j] > prevClosePos )
-            {
-                std::string s(prevClosePos, ' ');
-                s.append("^ is inside another array");
-                Logger::getInstance().errorAt("Board::__parse")
-                .explain(json).endl()
-                .explain(s).endl();
-                return NULL;
-            }
-            tokenMap[openPos] = closeTokens[j];
-            prevClosePos = closeTokens[j];
-            closeTokens[j] = -1;
-        }
-        else
-        {
-            std::string s(openPos, ' ');
-            s.append("^ no closing token for");
-            Logger::getInstance().errorAt("Board::__parse")
-            .explain(json).endl()
-            .explain(s).endl();
-            return NULL;
-        }
-    }
-    int boardHeight = tokenMap.size();
-
-    /* step 3
-     * build map with
-     * board row => elements
-     */
-    std::map<int, std::vector<int> > boardMap;
-    std::map<int, int>::iterator tmIt;
-    std::string splitter(1, ARRAY_ELEM_SPLITTER_CHAR);
-    unsigned int boardWidth = 0;
-    for ( tmIt = tokenMap.begin(); tmIt != tokenMap.end(); tmIt++ )
+/**
+ * Board::getMoves
+ *
+ * Fill moves with flat positions where empty cell can be moved
+ * in order left, up, right, down
+ * Width and Height are board dimensions known while compiling (0 if they are known only at runtime)
+ *
+ * Return count of moves
+ *
+ */
+template <int Width, int Height>
+inline int Board::getMoves(int * const moves)
+{
+    if constexpr ( Width > 0 )
     {
-        std::vector<int> parsedValues;
-        int startPos = (*tmIt).first + 1;
-        int stopPos = (*tmIt).second;
-        std::string rawStr(json, startPos, stopPos - startPos);
-        std::vector<std::string> rawValues;
-        boost::split(rawValues, rawStr, boost::is_any_of(splitter));
-        std::vector<std::string>::iterator rIt;
-        for ( rIt = rawValues.begin(); rIt != rawValues.end(); rIt++ )
-        {
-            try
-            {
-                int n = boost::lexical_cast<int>(*rIt);
-                parsedValues.push_back(n);
-            }
-            catch ( boost::bad_lexical_cast const& )
-            {
-                Logger::getInstance().errorAt("Board::__parse")
-                .explain("row ")
-                .append(ARRAY_START_CHAR)
-                .append(rawStr)
-                .append(ARRAY_END_CHAR)
-                .endl()
-                .explain("contains illegal integer '")
-                .append(*rIt)
-                .append("'")
-                .endl();
-                return NULL;
-            }
-        }
-        if ( ! boardWidth )
-        {
-            boardWidth = parsedValues.size();
-        }
-        if ( parsedValues.size() != boardWidth )
-        {
-            Logger::getInstance().errorAt("Board::__parse")
-            .explain("row ")
-            .append(ARRAY_START_CHAR)
-            .append(rawStr)
-            .append(ARRAY_END_CHAR)
-            .endl()
-            .explain("contains ")
-            .append(parsedValues.size())
-            .append(" values, but previous width = ")
-            .append(boardWidth)
-            .endl();
-            return NULL;
-        }
-        boardMap[(*tmIt).first] = parsedValues;
+        const BoardGeometryTables<Width, Height> &g = BoardGeometry<Width, Height>::tables;
+        for ( int i = 0; i < NEIGHBOURS_CNT_MAX; i++ )
+            moves[i] = g.moves[_blank][i];
+        return g.movesCnt[_blank];
     }
+    const int *m = &_moveTable->moves[_blank * NEIGHBOURS_CNT_MAX];
+    for ( int i = 0; i < NEIGHBOURS_CNT_MAX; i++ )
+        moves[i] = m[i];
+    return _moveTable->movesCnt[_blank];
+}
 
-    /* step 4
-     * check if board (width x height) has all values filled
-     */
-    int lexErrors = 0;
-    int size = boardWidth * boardHeight;
-    if ( size < 4 || boardWidth < 2 || boardHeight < 2 )
-    {
-        Logger::getInstance().errorAt("Board::__parse")
-        .explain("minimal board dimension is 2x2").endl();
-        return NULL;
-    }
-    int boardArr[size];
-    for ( int i = 0; i < size; i++ )
-    {
-        boardArr[i] = i;
-    }
-    std::map<int, std::vector<int> >::iterator bmIt;
-    for ( bmIt = boardMap.begin(); bmIt != boardMap.end(); bmIt++ )
-    {
-        std::vector<int> r = (*bmIt).second;
-        std::vector<int>::iterator rIt;
-        for ( rIt = r.begin(); rIt != r.end(); rIt++ )
-        {
-            if ( *rIt >= 0 && *rIt < size )
-            {
-                boardArr[*rIt] = -1;
-            }
-            else
-            {
-                lexErrors++;
-                Logger::getInstance().errorAt("Board::__parse")
-                .explain(*rIt)
-                .append(" is out of range").endl();
-            }
-        }
-    }
-    for ( int i = 0; i < size; i++ )
-    {
-        if ( boardArr[i] != -1 )
-        {
-            lexErrors++;
-            Logger::getInstance().errorAt("Board::__parse")
-            .explain(i)
-            .append(" missed").endl();
-        }
-    }
-    if ( lexErrors )
+/**
+ * Board::moveBlank
+ *
+ * Swap empty cell with cell at flat position
+ * For packed boards empty cell nibble is zero, so one xor moves the tile
+ * Width and Height are board dimensions known while compiling (0 if they are known only at runtime)
+ * This method is unsave!!!
+ * Because of Solver class performance it doesn't check input params and board state
+ *
+ */
+template <int Width, int Height>
+inline void Board::moveBlank(int pos)
+{
+    if ( Width ? Width * Height <= PACKED_SIZE_MAX : _size <= PACKED_SIZE_MAX )
     {
-        return NULL;
+        uint64_t tile = (_cells >> (pos * PACKED_CELL_BITS)) & PACKED_CELL_MASK;
+        _cells ^= (tile << (pos * PACKED_CELL_BITS)) | (tile << (_blank * PACKED_CELL_BITS));
     }
-
-    // string is valid
-    int **board = new int *[boardHeight];
-    for ( int i = 0; i < boardHeight; i++ )
-        board[i] = new int[boardWidth];
-    int x = 0;
-    for ( bmIt = boardMap.begin(); bmIt != boardMap.end(); bmIt++ )
+    else
     {
-        std::vector<int> r = (*bmIt).second;
-        for ( unsigned int y = 0; y < boardWidth; y++ )
-        {
-            board[x][y] = r[y];
-        }
-        x++;
+        _flatCells[_blank] = _flatCells[pos];
+        _flatCells[pos] = 0;
     }
-    width = boardWidth;
-    height = boardHeight;
-    return board;
+    _blank = pos;
 }
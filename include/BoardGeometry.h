@@ -0,0 +1,118 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BOARD_GEOMETRY_H
+#define BOARD_GEOMETRY_H
+
+#define NEIGHBOURS_CNT_MAX 4
+
+/**
+ * Tables of compile-time board geometry
+ *
+ */
+template <int W, int H>
+struct BoardGeometryTables
+{
+    signed char moves[W * H][NEIGHBOURS_CNT_MAX];  // empty cell position => positions where it can be moved
+    signed char movesCnt[W * H];                   // count of moves for each position
+    signed char cellX[W * H];                      // flat position => row
+    signed char cellY[W * H];                      // flat position => column
+    signed char goalX[W * H];                      // value => row in a goal state
+    signed char goalY[W * H];                      // value => column in a goal state
+    signed char mdDelta[W * H][W * H][W * H];      // value, from, to => change of Manhattan distance (0 for empty cell)
+};
+
+/**
+ * buildBoardGeometry
+ *
+ * Fill geometry tables while compiling
+ *
+ */
+template <int W, int H>
+constexpr BoardGeometryTables<W, H> buildBoardGeometry()
+{
+    BoardGeometryTables<W, H> t {};
+    for ( int pos = 0; pos < W * H; pos++ )
+    {
+        int x = pos / W;
+        int y = pos % W;
+        t.cellX[pos] = x;
+        t.cellY[pos] = y;
+
+        // same order as Board::getMoves (left, up, right, down)
+        int cnt = 0;
+        if ( y > 0 )
+            t.moves[pos][cnt++] = pos - 1;
+        if ( x > 0 )
+            t.moves[pos][cnt++] = pos - W;
+        if ( y < W - 1 )
+            t.moves[pos][cnt++] = pos + 1;
+        if ( x < H - 1 )
+            t.moves[pos][cnt++] = pos + W;
+        t.movesCnt[pos] = cnt;
+
+        // goal state is 1, 2, ..., size - 1, 0
+        int value = ( pos == W * H - 1 ) ? 0 : pos + 1;
+        t.goalX[value] = x;
+        t.goalY[value] = y;
+    }
+    for ( int value = 1; value < W * H; value++ )
+    {
+        for ( int from = 0; from < W * H; from++ )
+        {
+            int fx = t.cellX[from] - t.goalX[value];
+            int fy = t.cellY[from] - t.goalY[value];
+            int dFrom = ( fx < 0 ? -fx : fx ) + ( fy < 0 ? -fy : fy );
+            for ( int to = 0; to < W * H; to++ )
+            {
+                int tx = t.cellX[to] - t.goalX[value];
+                int ty = t.cellY[to] - t.goalY[value];
+                int dTo = ( tx < 0 ? -tx : tx ) + ( ty < 0 ? -ty : ty );
+                t.mdDelta[value][from][to] = dTo - dFrom;
+            }
+        }
+    }
+    return t;
+}
+
+/**
+ * Compile-time board geometry
+ *
+ * Width and height are known while compiling, so neighbour positions,
+ * cell coordinates and goal coordinates are constant tables the compiler
+ * can fold into search kernels (see IDA_Star::__DFS)
+ *
+ * W = 0 and H = 0 stand for runtime geometry and must not be instantiated
+ *
+ */
+template <int W, int H>
+struct BoardGeometry
+{
+    static constexpr int width  = W;
+    static constexpr int height = H;
+    static constexpr int size   = W * H;
+    static constexpr BoardGeometryTables<W, H> tables = buildBoardGeometry<W, H>();
+};
+
+#endif // BOARD_GEOMETRY_H
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FIFTEEN_API_H
+#define FIFTEEN_API_H
+
+/**
+ * Library interface for solving puzzles inside a process (C and C++)
+ *
+ * Nothing is printed, solution is written into buffers of caller
+ * Calls from different threads may run at the same time
+ *
+ * Example:
+ *
+ * int tiles[9] = {8,6,7, 2,5,4, 3,0,1};
+ * int moves[64];
+ * fifteen_options options;
+ * fifteen_result result;
+ * fifteen_default_options(&options);
+ * if ( fifteen_solve(tiles, 3, 3, &options, moves, 64, &result) == FIFTEEN_OK ) ...
+ *
+ */
+
+#define FIFTEEN_OK               0      // solution is written into moves
+#define FIFTEEN_INVALID          1      // tiles aren't a permutation of 0 .. width * height - 1 (or board is less than 2x2)
+#define FIFTEEN_UNSOLVABLE       2      // goal can't be reached from tiles
+#define FIFTEEN_NOT_FOUND        3      // no solution (time limit, cost limit or algorithm doesn't support board)
+#define FIFTEEN_BUFFER_TOO_SMALL 4      // solution is longer than moves buffer (steps count is set)
+#define FIFTEEN_BAD_OPTIONS      5      // unknown options size, algorithm or heuristic, or heuristic isn't available for board
+
+#define FIFTEEN_ALGORITHM_IDA    0      // IDA* (optimal)
+#define FIFTEEN_ALGORITHM_BIDA   1      // bidirectional IDA* (optimal, boards up to 16 cells)
+#define FIFTEEN_ALGORITHM_FRINGE 2      // fringe search (optimal, boards up to 16 cells)
+#define FIFTEEN_ALGORITHM_TABLE  3      // descent over table of exact costs (optimal, small boards only, ex. 3x3)
+#define FIFTEEN_ALGORITHM_LINES  4      // rows and columns are placed one at a time (not optimal, any board)
+
+#define FIFTEEN_HEURISTIC_MANHATTAN        0
+#define FIFTEEN_HEURISTIC_LINEAR_CONFLICT  1
+#define FIFTEEN_HEURISTIC_WALKING_DISTANCE 2 // boards up to 4x4, tables are built once per board dimension
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Options of solution, should be filled by fifteen_default_options first
+ * Size is checked by fifteen_solve, so caller built with other version of the struct gets FIFTEEN_BAD_OPTIONS
+ * New fields are added at the end only
+ *
+ */
+typedef struct
+{
+    int size;                           // sizeof(fifteen_options), set by fifteen_default_options
+    int algorithm;                      // FIFTEEN_ALGORITHM_*
+    int heuristic;                      // FIFTEEN_HEURISTIC_*
+    int threads;                        // worker threads of IDA* (1 - search in calling thread)
+    double weight;                      // weight of heuristic in IDA*, solution is at most weight * optimal
+    double timeLimit;                   // seconds of IDA* search, 0 - no limit
+    int memory;                         // MB for bida and fringe algorithms, 0 - default
+    int window;                         // moves shortened at once by lines algorithm, 0 - don't shorten
+    int movePruning;                    // skip duplicate move sequences by search algorithms (1 - yes, 0 - no)
+} fifteen_options;
+
+/**
+ * Result of solution
+ *
+ */
+typedef struct
+{
+    int status;                         // FIFTEEN_* status (the same as returned by fifteen_solve)
+    int stepsCnt;                       // count of moves in solution (0 if not found)
+    double nodesCnt;                    // count of steps made while searching solution
+    double time;                        // seconds
+} fifteen_result;
+
+void fifteen_default_options(fifteen_options *options);
+
+/**
+ * Solve board of width x height with flat tiles (row by row, 0 is empty cell)
+ * Goal has tiles 1 .. width * height - 1 in order and empty cell at the end
+ * Moves are tiles moved into empty cell, at most movesSize of them are written
+ * Options and result may be NULL
+ *
+ */
+int fifteen_solve(const int *tiles,
+                  int width,
+                  int height,
+                  const fifteen_options *options,
+                  int *moves,
+                  int movesSize,
+                  fifteen_result *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIFTEEN_API_H
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FRINGE_SEARCH_H
+#define FRINGE_SEARCH_H
+
+#include "Solver.h"
+#include <stdint.h>
+#include <vector>
+
+#define FRINGE_MEMORY_DEFAULT 256       // memory for stored states in MB
+#define FRINGE_NOT_LISTED     -2        // state isn't in fringe (it was expanded or it's new)
+#define FRINGE_SLOTS_MIN      (1 << 16) // initial count of slots of hash (it grows up to memory limit)
+
+/**
+ * Fringe search
+ *
+ * Like IDA* it searches states in depth-first order with increasing cost limits, but states exceeding limit
+ * are kept in fringe (list of states to search), so the next iteration continues from them instead of the root
+ * All reached states are stored with their costs, so each of them is expanded at most once per iteration
+ * If memory is over, search is restarted by IDA*
+ *
+ */
+class Fringe_Search : public Solver
+{
+public:
+    Fringe_Search(Board &board);
+    void setMemoryLimit(int mb);        // memory for stored states in MB
+    int solve();
+    ~Fringe_Search();
+private:
+    typedef int (Fringe_Search::*Search)();
+
+    /**
+     * Stored state, node of fringe list and of tree of best known paths
+     *
+     */
+    struct Node
+    {
+        uint64_t state;                 // packed cells
+        int parent;                     // index of node where the best known path comes from (-1 at the root)
+        int next;                       // next node in fringe (-1 at the end)
+        int prev;                       // previous node in fringe (-1 at the head, FRINGE_NOT_LISTED)
+        unsigned short g;               // count of moves of the best known path
+        unsigned short h;               // heuristic
+        unsigned char blank;            // flat position of empty cell
+        bool onBranch;                  // board is at this node or at it's descendant
+    };
+
+    size_t _memoryLimit;                // memory for stored states in bytes
+    std::vector<Node> _nodes;           // stored states (capacity is reserved, so nodes are never moved)
+    std::vector<int> _slots;            // open addressing hash of nodes (-1 is empty slot)
+    uint64_t _mask;                     // count of slots - 1
+    int _head;                          // the first node of fringe
+    std::vector<int> _branch;           // nodes from the root to the node of board state
+    std::vector<int> _chain;            // nodes from target back to branch (see Fringe_Search::__goTo)
+
+    Search __kernel();                  // choose search kernel for board dimension
+    uint64_t __hash(uint64_t state);    // slot of packed state
+    int __find(uint64_t state);         // slot of state or empty slot where it should be inserted
+    void __grow();                      // double count of slots
+    void __link(int node,
+                int after);             // insert node into fringe after other node
+    void __unlink(int node);            // remove node from fringe
+    int __savePath(int node);           // save path from the root to node as solution, return it's length
+    void __reset();                     // release stored states
+
+    template <int Width = 0, int Height = 0>
+    int __search();                     // search from the root (-1 if memory is over)
+    template <int Width = 0, int Height = 0>
+    void __goTo(int node);              // move board from current node to other one along tree of paths
+};
+
+#include "Fringe_Search.hpp"
+
+#endif // FRINGE_SEARCH_H
@@ -0,0 +1,288 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <limits>
+
+/**
+ * Fringe_Search::__hash
+ *
+ * Slot of packed state (bits of state are mixed, so neighbour states are spread over hash)
+ *
+ */
+inline uint64_t Fringe_Search::__hash(uint64_t state)
+{
+    state ^= state >> 33;
+    state *= 0xff51afd7ed558ccdULL;
+    state ^= state >> 33;
+    return state & _mask;
+}
+
+/**
+ * Fringe_Search::__find
+ *
+ * Return slot of packed state, or empty slot where it should be inserted
+ *
+ */
+inline int Fringe_Search::__find(uint64_t state)
+{
+    uint64_t slot = __hash(state);
+    for ( ; _slots[slot] >= 0; slot = (slot + 1) & _mask )
+    {
+        if ( _nodes[_slots[slot]].state == state )
+        {
+            break;
+        }
+    }
+    return slot;
+}
+
+/**
+ * Fringe_Search::__grow
+ *
+ * Double count of slots, so hash is filled at most by half (nodes reserved in memory limit always fit)
+ *
+ */
+inline void Fringe_Search::__grow()
+{
+    _mask = _mask * 2 + 1;
+    _slots.assign(_mask + 1, -1);
+    for ( unsigned int n = 0; n < _nodes.size(); n++ )
+    {
+        _slots[__find(_nodes[n].state)] = n;
+    }
+}
+
+/**
+ * Fringe_Search::__link
+ *
+ */
+inline void Fringe_Search::__link(int node, int after)
+{
+    Node &n = _nodes[node];
+    n.prev = after;
+    n.next = _nodes[after].next;
+    if ( n.next >= 0 )
+    {
+        _nodes[n.next].prev = node;
+    }
+    _nodes[after].next = node;
+}
+
+/**
+ * Fringe_Search::__unlink
+ *
+ */
+inline void Fringe_Search::__unlink(int node)
+{
+    Node &n = _nodes[node];
+    if ( n.prev >= 0 )
+    {
+        _nodes[n.prev].next = n.next;
+    }
+    else
+    {
+        _head = n.next;
+    }
+    if ( n.next >= 0 )
+    {
+        _nodes[n.next].prev = n.prev;
+    }
+    n.prev = FRINGE_NOT_LISTED;
+    n.next = -1;
+}
+
+/**
+ * Fringe_Search::__search
+ *
+ * Fringe is one list, where states of the current iteration (now) and of the next one (later) are mixed:
+ * state within cost limit is expanded and removed, it's children are inserted right after it,
+ * so they are searched next (depth-first order), state exceeding limit stays in fringe for the next iteration
+ * Child reached by a shorter path than stored one is moved after it's new parent
+ * Board follows searched state along tree of the best known paths (see Fringe_Search::__goTo)
+ *
+ * Return minimal count of moves (-1 if memory is over)
+ *
+ */
+template <int Width, int Height>
+inline int Fringe_Search::__search()
+{
+    int size = Width ? Width * Height : _board.getSize();
+    size_t nodesMax = _nodes.capacity();
+
+    _nodes.push_back(Node());
+    Node &root = _nodes.back();
+    root.state = _board.getPacked();
+    root.parent = -1;
+    root.next = -1;
+    root.prev = -1;
+    root.g = 0;
+    root.h = _hIndex[size];
+    root.blank = _board.getBlank();
+    root.onBranch = true;
+    _slots[__find(root.state)] = 0;
+    _head = 0;
+    _branch.assign(1, 0);
+
+    int F = root.h;
+    Logger::getInstance() << "F => " << F << " ";
+    while ( _head >= 0 )
+    {
+        int min = std::numeric_limits<int>::max();
+        int n = _head;
+        while ( n >= 0 )
+        {
+            Node &node = _nodes[n];
+            int f = node.g + node.h;
+            if ( f > F )
+            {
+
+                // stays in fringe for the next iteration
+                if ( f < min )
+                {
+                    min = f;
+                }
+                n = node.next;
+                continue;
+            }
+            if ( ! node.h )
+            {
+                __goTo<Width, Height>(0);
+                Logger::getInstance() << 0 << " ";
+                return __savePath(n);
+            }
+
+            __goTo<Width, Height>(n);
+            int moves[NEIGHBOURS_CNT_MAX];
+            int movesCnt = _board.getMoves<Width, Height>(moves);
+            int after = n;
+            int prev = node.parent >= 0 ? _nodes[node.parent].blank : -1;
+            for ( int i = 0; i < movesCnt; i++ )
+            {
+                int pos = moves[i];
+                if ( pos == prev )
+                {
+
+                    // parent is stored with less cost
+                    continue;
+                }
+                int nbr = _board.getCell<Width, Height>(pos);
+                int hNbr, hZero, hSum;
+                int H = __stepForward<Width, Height>(pos, nbr, hNbr, hZero, hSum);
+                uint64_t state = _board.getPacked();
+                __stepBack<Width, Height>(node.blank, nbr, hNbr, hZero, hSum);
+                _madeStepsCnt++;
+
+                int G = node.g + 1;
+                int slot = __find(state);
+                int child = _slots[slot];
+                if ( child >= 0 )
+                {
+                    if ( G >= _nodes[child].g )
+                    {
+
+                        // state is already reached by a path which isn't longer
+                        continue;
+                    }
+                    if ( _nodes[child].prev != FRINGE_NOT_LISTED )
+                    {
+                        __unlink(child);
+                    }
+                }
+                else
+                {
+                    if ( _nodes.size() == nodesMax )
+                    {
+                        __goTo<Width, Height>(0);
+                        return -1;
+                    }
+                    if ( _nodes.size() * 2 >= _slots.size() )
+                    {
+                        __grow();
+                        slot = __find(state);
+                    }
+                    child = _nodes.size();
+                    _slots[slot] = child;
+                    _nodes.push_back(Node());
+                    _nodes[child].state = state;
+                    _nodes[child].h = H;
+                    _nodes[child].blank = pos;
+                    _nodes[child].onBranch = false;
+                }
+                _nodes[child].parent = n;
+                _nodes[child].g = G;
+                __link(child, after);
+                after = child;
+            }
+
+            // children (if any) are the next ones
+            int next = node.next;
+            __unlink(n);
+            n = next;
+        }
+
+        F = min;
+        if ( F >= SOLUTION_LENGTH_MAX )
+        {
+            break;
+        }
+        Logger::getInstance() << F << " ";
+    }
+    __goTo<Width, Height>(0);
+    return std::numeric_limits<int>::max();
+}
+
+/**
+ * Fringe_Search::__goTo
+ *
+ * Board goes back along current branch to the closest ancestor of target, then forward to target
+ * Consecutive searched states are mostly close in tree, so only a few moves are needed
+ *
+ */
+template <int Width, int Height>
+inline void Fringe_Search::__goTo(int node)
+{
+    _chain.clear();
+    int ancestor = node;
+    while ( ! _nodes[ancestor].onBranch )
+    {
+        _chain.push_back(ancestor);
+        ancestor = _nodes[ancestor].parent;
+    }
+
+    int hNbr, hZero, hSum;
+    while ( _branch.back() != ancestor )
+    {
+        _nodes[_branch.back()].onBranch = false;
+        _branch.pop_back();
+        int pos = _nodes[_branch.back()].blank;
+        __stepForward<Width, Height>(pos, _board.getCell<Width, Height>(pos), hNbr, hZero, hSum);
+    }
+    for ( int i = _chain.size() - 1; i >= 0; i-- )
+    {
+        int pos = _nodes[_chain[i]].blank;
+        __stepForward<Width, Height>(pos, _board.getCell<Width, Height>(pos), hNbr, hZero, hSum);
+        _nodes[_chain[i]].onBranch = true;
+        _branch.push_back(_chain[i]);
+    }
+}
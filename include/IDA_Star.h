@@ -26,27 +26,173 @@
 #define IDA_STAR_H
 
 #include "Solver.h"
+#include "TranspositionTable.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <string>
+#include <unordered_set>
+#include <vector>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/bind/bind.hpp>
+
+#define IDA_SPLIT_DEPTH_MIN 8           // min remaining depth (F - G) of subtree given to another worker
+
+// order of children expansion (flags)
+#define MOVE_ORDER_NONE    0            // left, up, right, down
+#define MOVE_ORDER_COST    1            // children with less cost first
+#define MOVE_ORDER_HISTORY 2            // moves which led to the least costs exceeding limit in previous searches first
+#define IDA_ORDER_DEPTH_MIN 6           // min remaining depth (F - G) where children are ordered
+#define IDA_WEIGHT_STEP_MIN 0.05        // anytime search: weight closer to 1 than this is set to 1
+#define IDA_TIME_CHECK_MASK 0x3FFF      // time limit is checked once per (mask + 1) steps of DFS
 
 class IDA_Star : public Solver
 {
 public:
     IDA_Star(Board &board, int cpuUnits = 0);
     IDA_Star(const Solver &solver);
+    void setFrontierSize(int size);     // split search into jobs of frontier nodes (multi-threaded version)
+    void setAllSolutions(bool all);     // don't stop after the first optimal solution
+    bool setTranspositionTable(TranspositionTable *tt); // skip states already searched (boards up to 16 cells)
+    void setMoveOrdering(int order);    // order of children expansion (MOVE_ORDER_* flags)
+    bool setWeight(double weight);      // bounded-suboptimal search, cost = G + weight * H (weight >= 1)
+    void setAnytime(bool anytime);      // keep decreasing weight and improving solution while time allows
+    void setTimeLimit(double seconds);  // stop search after time limit (0 - no limit)
     int solve();
+    ~IDA_Star();
 private:
-    static int _slnFoundCnt;            // count of found solutions
-    static boost::mutex _sln_mutex;
+    typedef int (IDA_Star::*Iteration)(int F);
+
+    /**
+     * Frame of DFS stack (one per depth)
+     *
+     */
+    struct Frame
+    {
+        int moves[NEIGHBOURS_CNT_MAX];  // positions where empty cell can be moved
+        int movesCnt;
+        int next;                       // index of next move to check
+        int blank;                      // flat position of empty cell
+        int prev;                       // flat position of empty cell at previous depth (-1 at the root)
+        int fsm;                        // state of move automaton (0 at the root, see MoveAutomaton)
+        int cost[NEIGHBOURS_CNT_MAX];   // cost of each move (if moves are ordered by cost)
+        int min;                        // minimal found cost exceeding limit in subtree (0 if solution was found)
+        int hNbr;                       // heuristic saved by step forward (see Solver::__stepForward)
+        int hZero;
+        int hSum;
+    };
+
+    /**
+     * Subtree of multi-threaded search
+     *
+     */
+    struct Task
+    {
+        std::vector<int> moves;         // flat positions of empty cell after each move from the root
+        int id;                         // index of frontier node (-1 for shared subtree)
+        int fsm;                        // state of move automaton after the last move (0 for frontier node)
+    };
+
+    typedef int (IDA_Star::*Search)(int F,
+                                    const Task &task);
+
+    /**
+     * Worker of multi-threaded search
+     *
+     */
+    struct Worker
+    {
+        IDA_Star *solver;               // own solver (search context is reused in each iteration)
+        boost::mutex mutex;             // guards tasks
+        std::deque<Task> tasks;         // owner takes tasks from back, other workers steal from front
+        std::atomic<int> tasksCnt;
+        int min;                        // minimal found cost in current iteration
+        double madeStepsCnt;            // steps made in current iteration
+    };
+
+    /**
+     * Pool of workers, created once in solve and used in all iterations
+     *
+     */
+    struct Pool
+    {
+        IDA_Star *owner;                // solver with root state
+        Worker *workers;
+        int workersCnt;
+        boost::thread_group threads;
+        boost::mutex mutex;             // guards fields below
+        boost::condition_variable cond; // iteration started or finished
+        int F;
+        Search search;                  // search kernel of current iteration
+        unsigned int generation;        // number of iteration
+        bool stop;
+        std::atomic<int> pending;       // tasks not finished in current iteration
+        std::atomic<int> hungry;        // workers looking for a task
+        std::atomic<bool> cancel;       // solution was found, workers should stop
+        std::atomic<bool> timedOut;     // time limit was reached by one of workers
+        bool split;                     // busy workers share subtrees with hungry ones
+        std::vector<Task> frontier;     // nodes of breadth-first expanded root (see IDA_Star::setFrontierSize)
+        std::vector<int> bounds;        // frontier node => minimal cost exceeding limit in last search
+    };
+
+    Frame *_stack;                      // DFS stack, depth => frame (preallocated from arena)
+    Pool *_pool;                        // pool of workers (shared with workers)
+    std::vector<void*> _workerBlocks;   // memory of worker solvers, allocated once and reused by each pool
+    int _workerId;                      // index of worker in pool
+    std::vector<int> _taskMoves;        // moves of current task
+    int _frontierSize;                  // min count of frontier nodes (0 - subtrees are shared on demand)
+    bool _allSolutions;                 // search all optimal solutions
+    TranspositionTable *_tt;            // transposition table (shared with workers), NULL if not used
+    int _moveOrder;                     // order of children expansion (MOVE_ORDER_* flags)
+    unsigned int *_history;             // tile * 4 + direction => score of move (own for each worker)
+    double _weight;                     // weight of heuristic set by user (first weight of anytime search)
+    bool _anytime;                      // decrease weight after each found solution
+    double _timeLimit;                  // seconds, 0 - no limit
+    double _costWeight;                 // weight of heuristic in current search
+    int _upperBound;                    // cost of the best found solution, longer paths are pruned
+    double _deadline;                   // usec since epoch when search stops (0 - no limit)
+    unsigned int _ticks;                // steps since the last time check
+    bool _timedOut;                     // time limit was reached
+
+    IDA_Star(const IDA_Star &solver,
+             void *context);            // copy solver into preallocated search context
+    void __initStack();                 // allocate DFS stack and history of moves
+    void __solutionFound(int G);        // count and save solution, cancel other workers
+    void __collectSolution();           // take moves of the best solution from workers (workers are idle)
+    int __cost(int G,
+               int H);                  // weighted cost of path (max int if it can't improve found solution)
+    bool __checkDeadline();             // return true if time limit was reached (other workers are cancelled)
+    void __setSearch(double weight,
+                     int upperBound);   // set weight and bound of the next search to solver and workers
+    bool __isTimedOut();                // time limit was reached by solver or any worker
+
+    Iteration __kernel();               // choose search kernel specialized for board dimension
+    template <int Width, int Height>
+    int __iteration(int F);             // one iteration with cost limit F
+    template <int Width, int Height>
     int __DFS(int F,
               int G,
               int prev,
-              int *isBest);             // Depth-first search with cost limits
-    void __DFS_Multi(int F,
-                     int G,
-                     int prev,
-                     int *min,
-                     int *isBest);      // Multi-threaded version
+              int fsm);                 // Depth-first search with cost limits (iterative)
+    template <int Width, int Height>
+    void __expand(Frame *frame,
+                  int F,
+                  int G);               // fill moves of frame (ordered if needed)
+
+    void __startPool();                 // create workers and their threads
+    void __stopPool();                  // join threads and destroy workers
+    bool __buildFrontier();             // expand root breadth-first, return true if solution was found
+    int __poolIteration(int F,
+                        Search search); // one iteration of multi-threaded search
+    void __work();                      // thread of worker
+    bool __takeTask(Task &task);        // take own task or steal one from other worker
+    void __donate(int root,
+                  int G);               // give untried moves of the shallowest frame to hungry workers
+    template <int Width, int Height>
+    int __runTask(int F,
+                  const Task &task);    // search subtree of task
 };
 
 #include "IDA_Star.hpp"
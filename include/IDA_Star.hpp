@@ -23,314 +23,889 @@
  */
 
 /**
- * IDA_Star::__DFS
+ * IDA_Star::__solutionFound
  *
- * Depth-first search (DFS) algorithm with cost limits
- * F = total cost
- * G = current cost
+ * Count solution and save it if it's the best one (no lock, see Solver::__publishSolution)
+ * Workers publish solution into result of solver which created the pool and keep moves until
+ * the end of iteration (see IDA_Star::__collectSolution)
+ * Workers of multi-threaded version are cancelled unless all solutions are searched
  *
- * isBest - Address of variable with boolean value
- *     (unique in each iteration, shows if current solution is the best)
+ */
+inline void IDA_Star::__solutionFound(int G)
+{
+    __publishSolution(_pool ? _pool->owner->_sln : _sln, G);
+
+    if ( _pool && ! _allSolutions )
+    {
+        _pool->cancel = true;
+    }
+}
+
+/**
+ * IDA_Star::__collectSolution
  *
- * Return minimal found cost
+ * Take moves of the best solution from worker which published it's steps count,
+ * solutions of other workers are forgotten
+ * Should be called between iterations, while workers are idle
  *
  */
-inline int IDA_Star::__DFS(int F, int G, int prev, int *isBest)
+inline void IDA_Star::__collectSolution()
 {
-    int min = std::numeric_limits<int>::max();
-    int shuffleWith = 0;
-    int nbrs[NEIGHBOURS_CNT_MAX];
-    int cnt = _board.getNeigbours(0, nbrs);
+    for ( int i = 0; i < _pool->workersCnt; i++ )
+    {
+        Solution &sln = _pool->workers[i].solver->_sln;
+        if ( ! sln.shuffles.empty() && (int)sln.shuffles.size() == _sln.stepsCnt )
+        {
+            _sln.shuffles.swap(sln.shuffles);
+        }
+        sln.stepsCnt = std::numeric_limits<int>::max();
+        sln.shuffles.clear();
+    }
+}
 
-    for ( int i = 0; i < cnt; i++ )
+/**
+ * IDA_Star::__cost
+ *
+ * Cost of path with current cost G and heuristic H, heuristic is multiplied by weight of current search
+ * (rounded down, so cost never exceeds weight * length of the longest path through the state)
+ * Paths which can't be shorter than already found solution cost max int, so they are always pruned
+ *
+ */
+inline int IDA_Star::__cost(int G, int H)
+{
+    if ( G + H >= _upperBound )
+    {
+        return std::numeric_limits<int>::max();
+    }
+    if ( _costWeight > 1 )
+    {
+        return G + (int)(H * _costWeight);
+    }
+    return G + H;
+}
+
+/**
+ * IDA_Star::__checkDeadline
+ *
+ * Compare current time with deadline of search, workers of multi-threaded version are cancelled
+ * when any of them reaches the deadline
+ *
+ */
+inline bool IDA_Star::__checkDeadline()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    if ( (double)tv.tv_sec * 1000000 + tv.tv_usec < _deadline )
+    {
+        return false;
+    }
+    _timedOut = true;
+    if ( _pool )
     {
-        int nbr  = nbrs[i];
+        _pool->timedOut = true;
+        _pool->cancel = true;
+    }
+    return true;
+}
 
-        if ( nbr == prev )
+/**
+ * IDA_Star::__setSearch
+ *
+ * Weight and upper bound are changed only between searches, while workers are waiting
+ *
+ */
+inline void IDA_Star::__setSearch(double weight, int upperBound)
+{
+    _costWeight = weight;
+    _upperBound = upperBound;
+    if ( _pool )
+    {
+        for ( int i = 0; i < _pool->workersCnt; i++ )
         {
-            continue;
+            _pool->workers[i].solver->_costWeight = weight;
+            _pool->workers[i].solver->_upperBound = upperBound;
         }
+        _pool->bounds.assign(_pool->bounds.size(), 0);
+    }
+    if ( _tt )
+    {
 
-        int hn, hz, hs = 0;
+        // stored costs are valid only for the same weight and bound
+        _tt->clear();
+    }
+}
 
-        int H = __stepForward(nbr, hn, hz, hs);
-        int f = G + H;
+/**
+ * IDA_Star::__isTimedOut
+ *
+ */
+inline bool IDA_Star::__isTimedOut()
+{
+    return _timedOut || ( _pool && _pool->timedOut.load() );
+}
 
-        if ( f > F )
-        {
+/**
+ * IDA_Star::__initStack
+ *
+ * Allocate DFS stack from own arena (one frame per depth up to max solution length)
+ * and empty history of moves
+ *
+ */
+inline void IDA_Star::__initStack()
+{
+    _stack = (Frame*)_arena.allocate((SOLUTION_LENGTH_MAX + 1) * sizeof(Frame));
+    _history = (unsigned int*)_arena.allocate(_board.getSize() * NEIGHBOURS_CNT_MAX * sizeof(unsigned int));
+    memset(_history, 0, _board.getSize() * NEIGHBOURS_CNT_MAX * sizeof(unsigned int));
+}
 
-            // step back, this is wrong way
-            __stepBack(nbr, hn, hz, hs);
+/**
+ * IDA_Star::__startPool
+ *
+ * Create a worker for each processor unit, each worker has it's own solver
+ * (object and search context are one cache-line-aligned block from arena) and thread,
+ * threads sleep between iterations
+ * Blocks are allocated by the first pool only, so repeated solve calls don't grow arena
+ *
+ */
+inline void IDA_Star::__startPool()
+{
+    _pool = new Pool();
+    _pool->owner = this;
+    _pool->workersCnt = _cpuUnits;
+    _pool->workers = new Worker[_pool->workersCnt];
+    _pool->F = 0;
+    _pool->search = NULL;
+    _pool->generation = 0;
+    _pool->stop = false;
+    _pool->pending = 0;
+    _pool->hungry = 0;
+    _pool->cancel = false;
+    _pool->timedOut = false;
+    _pool->split = true;
+    while ( (int)_workerBlocks.size() < _pool->workersCnt )
+    {
+        _workerBlocks.push_back(_arena.allocate(sizeof(IDA_Star) + __contextSize()));
+    }
+    for ( int i = 0; i < _pool->workersCnt; i++ )
+    {
+        void *block = _workerBlocks[i];
+        IDA_Star *solver = new (block) IDA_Star(*this, (char*)block + sizeof(IDA_Star));
+        solver->_pool = _pool;
+        solver->_workerId = i;
+        _pool->workers[i].solver = solver;
+        _pool->workers[i].tasksCnt = 0;
+    }
+    for ( int i = 0; i < _pool->workersCnt; i++ )
+    {
+        _pool->threads.create_thread(boost::bind(&IDA_Star::__work, _pool->workers[i].solver));
+    }
+}
 
-            if ( shuffleWith )
-            {
+/**
+ * IDA_Star::__stopPool
+ *
+ * Wake up and join threads, destroy workers (their blocks are reused by the next pool)
+ *
+ */
+inline void IDA_Star::__stopPool()
+{
+    {
+        boost::mutex::scoped_lock lock(_pool->mutex);
+        _pool->stop = true;
+        _pool->cond.notify_all();
+    }
+    _pool->threads.join_all();
+    for ( int i = 0; i < _pool->workersCnt; i++ )
+    {
+        _pool->workers[i].solver->~IDA_Star();
+    }
+    delete[] _pool->workers;
+    delete _pool;
+    _pool = NULL;
+}
 
-                // solution was found in previous neighbours, should save it
-                break;
-            }
+/**
+ * IDA_Star::__poolIteration
+ *
+ * Run one iteration of multi-threaded search: root task is given to the first worker,
+ * other workers steal parts of it's subtree, iteration is finished when all tasks are finished
+ *
+ * Return next cost limit (0 if solution was found)
+ *
+ */
+inline int IDA_Star::__poolIteration(int F, Search search)
+{
+    for ( int i = 0; i < _pool->workersCnt; i++ )
+    {
+        _pool->workers[i].min = std::numeric_limits<int>::max();
+        _pool->workers[i].madeStepsCnt = 0;
+    }
+    _pool->F = F;
+    _pool->search = search;
+    _pool->cancel = false;
 
-            return f;
+    int tasksCnt = 0;
+    if ( _pool->frontier.empty() )
+    {
+        tasksCnt = 1;
+        _pool->pending = 1;
+        boost::mutex::scoped_lock lock(_pool->workers[0].mutex);
+        _pool->workers[0].tasks.push_back(Task());
+        _pool->workers[0].tasks.back().id = -1;
+        _pool->workers[0].tasks.back().fsm = 0;
+        _pool->workers[0].tasksCnt++;
+    }
+    else
+    {
+
+        // frontier nodes are dealt to workers in turn,
+        // nodes exceeding limit in previous iteration exceed this one too
+        for ( unsigned int i = 0; i < _pool->frontier.size(); i++ )
+        {
+            if ( _pool->bounds[i] <= F )
+                tasksCnt++;
         }
+        _pool->pending = tasksCnt;
+        for ( unsigned int i = 0, n = 0; i < _pool->frontier.size(); i++ )
+        {
+            if ( _pool->bounds[i] > F )
+            {
+                continue;
+            }
+            Worker &worker = _pool->workers[n++ % _pool->workersCnt];
+            boost::mutex::scoped_lock lock(worker.mutex);
+            worker.tasks.push_back(_pool->frontier[i]);
+            worker.tasksCnt++;
+        }
+    }
 
-        if ( ! H )
+    if ( tasksCnt )
+    {
+        boost::mutex::scoped_lock lock(_pool->mutex);
+        _pool->generation++;
+        _pool->cond.notify_all();
+        while ( _pool->pending.load() )
         {
-            IDA_Star::_slnFoundCnt++;
+            _pool->cond.wait(lock);
+        }
+    }
 
-            if ( G < Solver::_slnStepsCnt )
-            {
+    int min = std::numeric_limits<int>::max();
+    for ( int i = 0; i < _pool->workersCnt; i++ )
+    {
+        if ( _pool->workers[i].min < min )
+        {
+            min = _pool->workers[i].min;
+        }
 
-                // Yahoo!!! This is best solution
-                Solver::_slnStepsCnt = G;
-                Solver::_slnStates.clear();
-                Solver::_slnShuffles.clear();
+        // add worker made steps into main thread
+        _madeStepsCnt += _pool->workers[i].madeStepsCnt;
+    }
+    __collectSolution();
+    for ( unsigned int i = 0; i < _pool->bounds.size(); i++ )
+    {
+        if ( _pool->bounds[i] < min )
+        {
+            min = _pool->bounds[i];
+        }
+    }
+    return min;
+}
 
-                // save board in a goal state
-                Solver::_slnStates[G] = _board.toString();
-                Solver::_slnShuffles.push_back(nbr);
+/**
+ * IDA_Star::__buildFrontier
+ *
+ * Expand root breadth-first (without duplicates) until a level has at least _frontierSize nodes,
+ * nodes of this level are jobs of each iteration
+ * Every path to a goal which is longer than frontier depth passes through a frontier node,
+ * shorter ones are found while expanding
+ *
+ * Return true if solution was found while expanding
+ *
+ */
+inline bool IDA_Star::__buildFrontier()
+{
+    int size = _board.getSize();
+    int goal[BOARD_CELLS_MAX];
+    getGoal(goal);
+
+    std::vector<Board> boards(1, _board);
+    std::vector<std::vector<int> > moves(1);
+    std::unordered_set<std::string> seen;
+    std::string key(2 * size, 0);
+    for ( int pos = 0; pos < size; pos++ )
+    {
+        key[2 * pos] = _board.getCell(pos) & 0xFF;
+        key[2 * pos + 1] = _board.getCell(pos) >> 8;
+    }
+    seen.insert(key);
 
-                if ( isBest )
+    int depth = 0;
+    while ( (int)boards.size() < _frontierSize )
+    {
+        std::vector<Board> nextBoards;
+        std::vector<std::vector<int> > nextMoves;
+        for ( unsigned int n = 0; n < boards.size(); n++ )
+        {
+            int nbrs[NEIGHBOURS_CNT_MAX];
+            int cnt = boards[n].getMoves(nbrs);
+            for ( int i = 0; i < cnt; i++ )
+            {
+                Board board = boards[n];
+                board.moveBlank(nbrs[i]);
+                bool isGoal = true;
+                for ( int pos = 0; pos < size; pos++ )
+                {
+                    int value = board.getCell(pos);
+                    key[2 * pos] = value & 0xFF;
+                    key[2 * pos + 1] = value >> 8;
+                    isGoal = isGoal && goal[value] == pos;
+                }
+                if ( ! seen.insert(key).second )
+                {
+                    continue;
+                }
+                nextMoves.push_back(moves[n]);
+                nextMoves.back().push_back(nbrs[i]);
+                if ( isGoal )
                 {
-                    *isBest = 1;
+
+                    // replay moves to get moved tiles
+                    Board replay = _board;
+                    const std::vector<int> &path = nextMoves.back();
+                    for ( unsigned int k = 0; k < path.size(); k++ )
+                    {
+                        _path[k + 1] = replay.getCell(path[k]);
+                        replay.moveBlank(path[k]);
+                    }
+                    __solutionFound(path.size());
+                    return true;
                 }
+                nextBoards.push_back(board);
             }
+        }
+        if ( nextBoards.empty() )
+        {
+            break;
+        }
+        boards.swap(nextBoards);
+        moves.swap(nextMoves);
+        depth++;
+    }
+
+    _pool->split = false;
+    _pool->frontier.resize(moves.size());
+    _pool->bounds.assign(moves.size(), 0);
+    for ( unsigned int n = 0; n < moves.size(); n++ )
+    {
+        _pool->frontier[n].moves.swap(moves[n]);
+        _pool->frontier[n].id = n;
+        _pool->frontier[n].fsm = 0;
+    }
+    Logger::getInstance().append("frontier ").append(moves.size())
+    .append(" nodes at depth ").append(depth).append(", ");
+    return false;
+}
 
-            __stepBack(nbr, hn, hz, hs);
+/**
+ * IDA_Star::__work
+ *
+ * Thread of worker: wait for iteration, then take (or steal) and search tasks
+ * until all tasks of iteration are finished
+ *
+ */
+inline void IDA_Star::__work()
+{
+    Worker &worker = _pool->workers[_workerId];
+    unsigned int generation = 0;
+    for ( ;; )
+    {
+        {
+            boost::mutex::scoped_lock lock(_pool->mutex);
+            while ( ! _pool->stop && _pool->generation == generation )
+            {
+                _pool->cond.wait(lock);
+            }
+            if ( _pool->stop )
+            {
+                return;
+            }
+            generation = _pool->generation;
+        }
 
-            if ( Solver::_slnStates.size() == 1 )
+        while ( _pool->pending.load() )
+        {
+            Task task;
+            if ( ! __takeTask(task) )
             {
+                if ( ! _pool->split )
+                {
+
+                    // frontier jobs are never split
+                    break;
+                }
 
-                // save previous board state
-                Solver::_slnStates[G - 1] = _board.toString();
+                // wait until busy workers share their subtrees
+                _pool->hungry++;
+                bool taken = false;
+                while ( _pool->pending.load() && ! ( taken = __takeTask(task) ) )
+                {
+                    boost::this_thread::yield();
+                }
+                _pool->hungry--;
+                if ( ! taken )
+                {
+                    break;
+                }
             }
 
-            return H;
-        }
+            int m = (this->*_pool->search)(_pool->F, task);
+            if ( m < worker.min )
+            {
+                worker.min = m;
+            }
+            if ( task.id >= 0 )
+            {
+                _pool->bounds[task.id] = m;
+            }
+            worker.madeStepsCnt += _madeStepsCnt;
 
-        int best = 0;
+            if ( _pool->pending.fetch_sub(1) == 1 )
+            {
 
-        // recursive call
-        int m = __DFS(F, G + 1, nbr, &best);
+                // the last task of iteration
+                boost::mutex::scoped_lock lock(_pool->mutex);
+                _pool->cond.notify_all();
+            }
+        }
+    }
+}
 
-        if ( m < min )
+/**
+ * IDA_Star::__takeTask
+ *
+ * Take the last own task (the deepest one) or steal the first task (the shallowest one)
+ * of other worker
+ *
+ */
+inline bool IDA_Star::__takeTask(Task &task)
+{
+    for ( int i = 0; i < _pool->workersCnt; i++ )
+    {
+        Worker &worker = _pool->workers[(_workerId + i) % _pool->workersCnt];
+        if ( ! worker.tasksCnt.load(std::memory_order_relaxed) )
         {
-            min = m;
+            continue;
         }
-
-        if ( best )
+        boost::mutex::scoped_lock lock(worker.mutex);
+        if ( worker.tasks.empty() )
         {
-
-            // swapping with this neighbour is best solution
-            shuffleWith = nbr;
+            continue;
         }
-
-        __stepBack(nbr, hn, hz, hs);
+        Task &taken = i ? worker.tasks.front() : worker.tasks.back();
+        task.moves.swap(taken.moves);
+        task.id = taken.id;
+        task.fsm = taken.fsm;
+        if ( ! i )
+        {
+            worker.tasks.pop_back();
+        }
+        else
+        {
+            worker.tasks.pop_front();
+        }
+        worker.tasksCnt--;
+        return true;
     }
+    return false;
+}
 
-    // save current board state if best solution was found
-    if ( ! min && shuffleWith )
+/**
+ * IDA_Star::__donate
+ *
+ * Give untried moves of the shallowest frame (the biggest subtrees) to own task queue,
+ * so hungry workers can steal them
+ * Nothing is given while own queue isn't empty or remaining depth is too small
+ * root = depth of the first frame of current task
+ * G = current depth
+ *
+ */
+inline void IDA_Star::__donate(int root, int G)
+{
+    Worker &worker = _pool->workers[_workerId];
+    if ( worker.tasksCnt.load(std::memory_order_relaxed) )
     {
-        Solver::_slnStates[G - 1] = _board.toString();
-        Solver::_slnShuffles.push_back(shuffleWith);
+        return;
     }
-
-    if ( isBest && shuffleWith )
+    for ( int d = root; d <= G && _pool->F - d >= IDA_SPLIT_DEPTH_MIN; d++ )
     {
+        Frame *frame = &_stack[d];
+        int cnt = 0;
+        int fsm[NEIGHBOURS_CNT_MAX];
+        for ( int i = frame->next; i < frame->movesCnt; i++ )
+        {
+            fsm[i] = 0;
+            if ( _automaton )
+            {
+                int direction = MoveAutomaton::getDirection(_board.getWidth(), frame->blank, frame->moves[i]);
+                fsm[i] = _automaton->next(frame->fsm, direction);
+            }
+            if ( frame->moves[i] != frame->prev && fsm[i] != MOVE_AUTOMATON_PRUNED )
+            {
+                cnt++;
+            }
+        }
+        if ( ! cnt )
+        {
+            continue;
+        }
 
-        // this branch is the best
-        *isBest = 1;
+        // moves from the root to this frame
+        std::vector<int> moves(_taskMoves);
+        for ( int k = root + 1; k <= d; k++ )
+        {
+            moves.push_back(_stack[k].blank);
+        }
+
+        _pool->pending += cnt;
+        boost::mutex::scoped_lock lock(worker.mutex);
+        for ( int i = frame->next; i < frame->movesCnt; i++ )
+        {
+            if ( frame->moves[i] != frame->prev && fsm[i] != MOVE_AUTOMATON_PRUNED )
+            {
+                worker.tasks.push_back(Task());
+                worker.tasks.back().id = -1;
+                worker.tasks.back().fsm = fsm[i];
+                worker.tasks.back().moves = moves;
+                worker.tasks.back().moves.push_back(frame->moves[i]);
+            }
+        }
+        worker.tasksCnt += cnt;
+        frame->next = frame->movesCnt;
+        return;
     }
+}
 
-    return min;
+/**
+ * IDA_Star::__iteration
+ *
+ * Run one iteration of IDA* with cost limit F
+ * Width and Height are board dimensions known while compiling (0 if they are known only at runtime)
+ *
+ * Return next cost limit (0 if solution was found)
+ *
+ */
+template <int Width, int Height>
+inline int IDA_Star::__iteration(int F)
+{
+    if ( _pool )
+    {
+        return __poolIteration(F, &IDA_Star::__runTask<Width, Height>);
+    }
+    return __DFS<Width, Height>(F, 1, -1, 0);
 }
 
 /**
- * IDA_Star::__DFS_Multi
+ * IDA_Star::__DFS
+ *
+ * Depth-first search (DFS) algorithm with cost limits
+ * F = total cost
+ * G = current cost
+ * prev = flat position of empty cell before previous step (-1 at the root)
+ * fsm = state of move automaton at the root
  *
- * Multi-threaded version
+ * Search is a loop over preallocated stack of frames (frame at depth G is _stack[G]),
+ * so there is no recursion and search state of each depth is explicit
+ * Current path is kept in a search context (move at depth G is _path[G]),
+ * so solution is just copied from it when goal is reached
+ * Moves completing duplicate sequences are skipped (see MoveAutomaton), shared subtrees continue automaton
+ * of their owner, while frontier nodes start it again (their path is any of equal ones)
+ * States already searched are skipped by transposition table (see TranspositionTable::visit)
+ * Cost of path is weighted (see IDA_Star::__cost), search is stopped at deadline if time is limited
+ *
+ * Return minimal found cost (0 if solution was found)
  *
  */
-inline void IDA_Star::__DFS_Multi(int F, int G, int prev, int *min, int *isBest)
+template <int Width, int Height>
+inline int IDA_Star::__DFS(int F, int G, int prev, int fsm)
 {
-    boost::thread_group *nbrWorkers = NULL;
+    int root = G;
+    Frame *frame = &_stack[G];
+    frame->blank = _board.getBlank();
+    frame->prev = prev;
+    frame->fsm = fsm;
+    __expand<Width, Height>(frame, F, G);
+
+    for ( ;; )
+    {
+        if ( frame->next == frame->movesCnt )
+        {
 
-    // each thread should have it's own Solver
-    IDA_Star *nbrSolvers[NEIGHBOURS_CNT_MAX];
-    int minimals[NEIGHBOURS_CNT_MAX];
-    int bestFlags[NEIGHBOURS_CNT_MAX];
-    int nbrs[NEIGHBOURS_CNT_MAX];
-    int nbrsCnt = _board.getNeigbours(0, nbrs);
+            // all neighbours were checked, go back to previous depth
+            if ( G == root )
+            {
+                break;
+            }
+            int min = frame->min;
+            int blank = frame->blank;
+            G--;
+            frame--;
+            __stepBack<Width, Height>(frame->blank, _path[G], frame->hNbr, frame->hZero, frame->hSum);
 
-    // uniquely processed neighbours (without previous)
-    int realNbrs[NEIGHBOURS_CNT_MAX];
-    int realNbrsCnt = 0;
-    int shuffleWith = 0;
+            if ( min < frame->min )
+            {
+                frame->min = min;
+            }
+            if ( (_moveOrder & MOVE_ORDER_HISTORY) && min <= F + 2 )
+            {
 
-    int localMin = std::numeric_limits<int>::max();
-    int localSlnStepsCnt = std::numeric_limits<int>::max();
+                // subtree is close to limit, so it's likely searched deeper in the next iteration
+                int direction = MoveAutomaton::getDirection(Width ? Width : _board.getWidth(), frame->blank, blank);
+                _history[_path[G] * NEIGHBOURS_CNT_MAX + direction] += F - G;
+            }
 
-    for ( int i = 0; i < nbrsCnt; i++ )
-    {
-        int nbr  = nbrs[i];
+            if ( ! min && ! _allSolutions )
+            {
 
-        if ( nbr == prev )
-        {
+                // solution was found, skip other neighbours
+                frame->next = frame->movesCnt;
+            }
             continue;
         }
 
-        int hn, hz, hs = 0;
-
-        int H = __stepForward(nbr, hn, hz, hs);
-        int f = G + H;
-
-        if ( f > F )
+        if ( _deadline && ! (++_ticks & IDA_TIME_CHECK_MASK) && __checkDeadline() )
         {
 
-            // step back, this is wrong way
-            __stepBack(nbr, hn, hz, hs);
-
-            // maybe solution was found in previous neighbours, we should check it
-            localMin = f;
-            break;
+            // time is over, unwind the stack, so board returns to the root state
+            for ( int d = root; d <= G; d++ )
+            {
+                _stack[d].next = _stack[d].movesCnt;
+            }
+            continue;
         }
 
-        if ( ! H )
+        if ( _pool )
         {
-
-            // critical section
-            boost::mutex::scoped_lock lock(IDA_Star::_sln_mutex);
-            IDA_Star::_slnFoundCnt++;
-
-            if ( G < Solver::_slnStepsCnt )
+            if ( _pool->cancel.load(std::memory_order_relaxed) )
             {
 
-                // Yahoo!!! This is best solution
-                Solver::_slnStepsCnt = G;
-                Solver::_slnStates.clear();
-                Solver::_slnShuffles.clear();
-
-                // save board in a goal state
-                Solver::_slnStates[G] = _board.toString();
-                Solver::_slnShuffles.push_back(nbr);
+                // solution was found by other worker, state of this one doesn't matter
+                break;
+            }
+            if ( _pool->hungry.load(std::memory_order_relaxed) )
+            {
 
-                if ( isBest )
+                // some workers are idle, share a part of this subtree
+                __donate(root, G);
+                if ( frame->next == frame->movesCnt )
                 {
-
-                    // here we are saving best solution cost (not just boolean flag)
-                    *isBest = G;
+                    continue;
                 }
             }
+        }
 
-            __stepBack(nbr, hn, hz, hs);
+        int pos = frame->moves[frame->next++];
 
-            if ( Solver::_slnStates.size() == 1 )
+        if ( pos == frame->prev )
+        {
+            continue;
+        }
+
+        int state = 0;
+        if ( _automaton )
+        {
+            int direction = MoveAutomaton::getDirection(Width ? Width : _board.getWidth(), frame->blank, pos);
+            state = _automaton->next(frame->fsm, direction);
+            if ( state == MOVE_AUTOMATON_PRUNED )
             {
 
-                // save previous board state
-                Solver::_slnStates[G - 1] = _board.toString();
+                // the same state is reached by a preferred sequence of moves
+                continue;
             }
+        }
 
-            *min = H;
+        if ( (_moveOrder & MOVE_ORDER_COST) && frame->cost[frame->next - 1] > F )
+        {
 
-            if ( nbrWorkers )
+            // cost is known from ordering
+            if ( frame->cost[frame->next - 1] < frame->min )
             {
-
-                // if some threads are running, sould be interrupted
-                nbrWorkers->join_all();
-                for ( int i = 0; i < realNbrsCnt; i++ )
-                {
-                    delete nbrSolvers[i];
-                }
-                delete nbrWorkers;
+                frame->min = frame->cost[frame->next - 1];
             }
-            return;
+            continue;
         }
 
-        bestFlags[realNbrsCnt] = std::numeric_limits<int>::max();
+        int nbr = _board.getCell<Width, Height>(pos);
+        int H = __stepForward<Width, Height>(pos, nbr, frame->hNbr, frame->hZero, frame->hSum);
+        int f = __cost(G, H);
 
-        if ( G > Solver::_cpu_units )
+        if ( frame->cost[frame->next - 1] )
         {
 
-            // recursive call
-            __DFS_Multi(F, G + 1, nbr, &minimals[realNbrsCnt], &bestFlags[realNbrsCnt]);
+            // child was already counted, when it was made for ordering
+            _madeStepsCnt--;
         }
-        else
+
+        if ( f > F )
         {
 
-            // create a copy of current object
-            nbrSolvers[realNbrsCnt] = new IDA_Star(*this);
+            // step back, this is wrong way, but other neighbours still should be checked
+            __stepBack<Width, Height>(frame->blank, nbr, frame->hNbr, frame->hZero, frame->hSum);
 
-            if ( ! nbrWorkers )
+            if ( f < frame->min )
             {
-                nbrWorkers = new boost::thread_group();
+                frame->min = f;
             }
+            continue;
+        }
+
+        if ( _tt && ! _allSolutions && H && _tt->visit(_board.getPacked(), state, G, F) )
+        {
 
-            // this neighbour will be processed in a separated thread
-            boost::thread *worker = new boost::thread(
-                &IDA_Star::__DFS_Multi,
-                boost::ref(nbrSolvers[realNbrsCnt]),
-                F,
-                G + 1,
-                nbr,
-                &minimals[realNbrsCnt],
-                &bestFlags[realNbrsCnt]);
-            nbrWorkers->add_thread(worker);
+            // state was reached by a shorter path or it's subtree is searched by other path
+            __stepBack<Width, Height>(frame->blank, nbr, frame->hNbr, frame->hZero, frame->hSum);
+            continue;
         }
 
-        __stepBack(nbr, hn, hz, hs);
-        realNbrs[realNbrsCnt++] = nbr;
+        _path[G] = nbr;
+
+        if ( ! H )
+        {
+            __solutionFound(G);
+            __stepBack<Width, Height>(frame->blank, nbr, frame->hNbr, frame->hZero, frame->hSum);
+            frame->min = H;
+            if ( ! _allSolutions )
+            {
+                frame->next = frame->movesCnt;
+            }
+            continue;
+        }
+
+        // go to next depth
+        G++;
+        frame++;
+        frame->blank = pos;
+        frame->prev = (frame - 1)->blank;
+        frame->fsm = state;
+        __expand<Width, Height>(frame, F, G);
     }
 
-    if ( nbrWorkers )
+    return _stack[root].min;
+}
+
+/**
+ * IDA_Star::__expand
+ *
+ * Fill moves of empty cell for a frame, G is depth of children
+ * Moves are ordered only if remaining depth is at least IDA_ORDER_DEPTH_MIN
+ * Moves may be ordered by cost of child (each child is made and rolled back, cost is saved in frame)
+ * and then by history score of move
+ *
+ */
+template <int Width, int Height>
+inline void IDA_Star::__expand(Frame *frame, int F, int G)
+{
+    frame->next = 0;
+    frame->min = std::numeric_limits<int>::max();
+    frame->movesCnt = _board.getMoves<Width, Height>(frame->moves);
+    if ( ! _moveOrder || F - G < IDA_ORDER_DEPTH_MIN )
     {
-        nbrWorkers->join_all();
-        for ( int i = 0; i < realNbrsCnt; i++ )
-        {
 
-            // add worker thread made steps into main thread
-            this->_madeStepsCnt += nbrSolvers[i]->_madeStepsCnt;
-            delete nbrSolvers[i];
+        // small subtrees are cheaper to search in fixed order
+        for ( int i = 0; i < frame->movesCnt; i++ )
+        {
+            frame->cost[i] = 0;
         }
-        delete nbrWorkers;
+        return;
     }
 
-    for ( int i = 0; i < realNbrsCnt; i++ )
+    unsigned int score[NEIGHBOURS_CNT_MAX];
+    for ( int i = 0; i < frame->movesCnt; i++ )
     {
-        if ( minimals[i] < localMin )
+        int pos = frame->moves[i];
+        int nbr = _board.getCell<Width, Height>(pos);
+        frame->cost[i] = 0;
+        if ( (_moveOrder & MOVE_ORDER_COST) && pos != frame->prev )
         {
-            localMin = minimals[i];
+            int hNbr, hZero, hSum;
+            frame->cost[i] = __cost(G, __stepForward<Width, Height>(pos, nbr, hNbr, hZero, hSum));
+            __stepBack<Width, Height>(frame->blank, nbr, hNbr, hZero, hSum);
         }
-
-        if ( bestFlags[i] < localSlnStepsCnt )
+        score[i] = 0;
+        if ( _moveOrder & MOVE_ORDER_HISTORY )
         {
+            int direction = MoveAutomaton::getDirection(Width ? Width : _board.getWidth(), frame->blank, pos);
+            score[i] = _history[nbr * NEIGHBOURS_CNT_MAX + direction];
+        }
+    }
 
-            // critical section
-            boost::mutex::scoped_lock lock(IDA_Star::_sln_mutex);
-            if ( bestFlags[i] == Solver::_slnStepsCnt )
+    // insertion sort, less cost first, then greater score
+    for ( int i = 1; i < frame->movesCnt; i++ )
+    {
+        for ( int k = i; k > 0; k-- )
+        {
+            if ( frame->cost[k - 1] < frame->cost[k]
+                 || (frame->cost[k - 1] == frame->cost[k] && score[k - 1] >= score[k]) )
             {
-                localSlnStepsCnt = bestFlags[i];
-                shuffleWith = realNbrs[i];
+                break;
             }
+            std::swap(frame->moves[k - 1], frame->moves[k]);
+            std::swap(frame->cost[k - 1], frame->cost[k]);
+            std::swap(score[k - 1], score[k]);
         }
     }
+}
 
-    // save current board state if best solution was found
-    if ( ! localMin && shuffleWith )
+/**
+ * IDA_Star::__runTask
+ *
+ * Search subtree of task: root state is loaded from pool owner and task moves are replayed,
+ * the last move isn't checked yet (see IDA_Star::__donate)
+ *
+ * Return minimal found cost (0 if solution was found)
+ *
+ */
+template <int Width, int Height>
+inline int IDA_Star::__runTask(int F, const Task &task)
+{
+    if ( _pool->cancel.load(std::memory_order_relaxed) )
     {
 
-        // critical section
-        boost::mutex::scoped_lock lock(IDA_Star::_sln_mutex);
-        Solver::_slnStates[G - 1] = _board.toString();
-        Solver::_slnShuffles.push_back(shuffleWith);
+        // solution was found, the rest of tasks are dropped
+        _madeStepsCnt = 0;
+        return std::numeric_limits<int>::max();
     }
-
-    if ( isBest && shuffleWith )
+    __load(*_pool->owner, 0);
+    _taskMoves = task.moves;
+
+    int depth = task.moves.size();
+    int prev = -1;
+    int H = _hIndex[Width ? Width * Height : _board.getSize()];
+    int hn, hz, hs = 0;
+    for ( int i = 0; i < depth; i++ )
     {
-
-        // this branch is the best
-        *isBest = localSlnStepsCnt;
+        prev = _board.getBlank();
+        int pos = task.moves[i];
+        int nbr = _board.getCell<Width, Height>(pos);
+        H = __stepForward<Width, Height>(pos, nbr, hn, hz, hs);
+        _path[i + 1] = nbr;
     }
 
-    *min = localMin;
-    return;
-}
+    // replayed moves were counted by owner of the task, except the last one
+    _madeStepsCnt = depth ? 1 : 0;
 
+    if ( depth )
+    {
+        int f = __cost(depth, H);
+        if ( f > F )
+        {
+            return f;
+        }
+        if ( ! H )
+        {
+            __solutionFound(depth);
+            return 0;
+        }
+    }
+    return __DFS<Width, Height>(F, depth + 1, prev, task.fsm);
+}
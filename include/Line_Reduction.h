@@ -0,0 +1,91 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LINE_REDUCTION_H
+#define LINE_REDUCTION_H
+
+#include "Solver.h"
+#include <vector>
+
+#define LINE_WINDOW_NODES_MAX 20000     // max states searched while shortening one window of solution
+#define LINE_PAIR_CELLS 6               // cells of 3x2 window where the last two tiles of line are placed
+
+/**
+ * Constructive solver for boards of any dimension (ex. 20x20)
+ * Rows and columns are placed one at a time, until 2x2 corner is left, then path may be shortened
+ * by optimal search in sliding windows
+ *
+ */
+class Line_Reduction : public Solver
+{
+public:
+    Line_Reduction(Board &board);
+    void setWindow(int moves);          // shorten solution in windows of moves (0 - don't shorten)
+    int solve();
+    ~Line_Reduction();
+private:
+    int _window;                        // length of shortened windows
+    const MoveTable *_moveTable;        // moves of empty cell
+    std::vector<int> _goalValue;        // flat position => value in a goal state
+    std::vector<int> _cells;            // flat position => value (current state)
+    std::vector<int> _places;           // value => flat position (current state)
+    std::vector<char> _locked;          // flat position => 1 if cell is already placed
+    int _blank;                         // flat position of empty cell
+    std::vector<int> _moves;            // moved tiles (solution)
+    std::vector<unsigned int> _stamp;   // flat position => id of the last search which reached it
+    unsigned int _stampId;
+    std::vector<int> _from;             // flat position => previous position on route
+    std::vector<int> _queue;            // breadth-first search queue
+    std::vector<int> _route;            // the last found route (without start position)
+    std::vector<int> _targetPlaces;     // value => flat position (end state of shortened window)
+    std::vector<int> _segment;          // moved tiles of found window path
+    int _nodes;                         // states searched for current window
+
+    void __load();                      // load start state from board
+    bool __reduce();                    // place rows and columns, then rotate 2x2 corner
+    bool __placeLine(const std::vector<int> &line,
+                     int inward);       // place tiles of row or column
+    bool __placePair(int first,
+                     int last,
+                     int inward);       // place the last two tiles of line inside 3x2 window
+    bool __rotateCorner();              // solve the last 2x2 corner
+    bool __moveTile(int value,
+                    int target);        // move tile along shortest route over free cells
+    bool __moveBlank(int target,
+                     int avoid);        // move empty cell to target around cell avoid
+    bool __findRoute(int from,
+                     int to,
+                     int avoid);        // breadth-first search over free cells
+    void __swap(int pos);               // move empty cell to neighbour position
+    void __shift(int pos);              // move empty cell and save moved tile
+    int __distance(int pos,
+                   int target);         // Manhattan distance between positions
+    void __shorten();                   // replace windows of solution with shorter paths
+    bool __searchWindow(int depth,
+                        int limit,
+                        int h,
+                        int prev);      // depth-first search of window end state
+};
+
+#endif // LINE_REDUCTION_H
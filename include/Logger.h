@@ -40,6 +40,8 @@ class Logger
 {
 public:
     static Logger& getInstance();
+    static void setInstance(Logger *logger);   // replace instance (caller owns it, set before threads start)
+    static Logger* setThreadInstance(Logger *logger); // replace instance in calling thread only, return previous one
     Logger& errorAt(const std::string funcName);
     Logger& explain(const std::string message);
     Logger& append(const std::string s);
@@ -52,6 +54,7 @@ public:
     template <typename T> Logger& append(const T message);
 private:
     static Logger *_loggerInstance;
+    static thread_local Logger *_threadLoggerInstance;
 protected:
     virtual void write(const std::string message) = 0;
 };
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MOVE_AUTOMATON_H
+#define MOVE_AUTOMATON_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+#define MOVE_AUTOMATON_DEPTH 12         // max length of move sequences checked for duplicates
+#define MOVE_AUTOMATON_DEPTH_DEFAULT 8  // length checked by default (built in ~10 ms on any board)
+#define MOVE_AUTOMATON_DEPTH_4x4 10     // length checked by default for boards of 10..16 cells (built in ~70 ms)
+#define MOVE_AUTOMATON_PRUNED -1        // transition of a move which is pruned
+
+// directions of empty cell moves
+#define MOVE_LEFT  0
+#define MOVE_UP    1
+#define MOVE_RIGHT 2
+#define MOVE_DOWN  3
+
+/**
+ * Finite state machine of duplicate move sequences for one board geometry
+ *
+ * Sequence of empty cell moves is a duplicate, if other sequence, which is shorter
+ * (or has the same length, but is less lexicographically), gives the same state and stays in
+ * bounds of the first one (so it's possible whenever the first one is possible)
+ * Search consults transition table on each move, so paths with duplicate sequences are never expanded
+ *
+ */
+class MoveAutomaton
+{
+public:
+    MoveAutomaton();
+    static const MoveAutomaton* get(int width,
+                                    int height,
+                                    int depth = 0);  // get (build if needed) automaton for geometry
+    static int getDefaultDepth(int width,
+                               int height);       // length of checked sequences, which pays off for geometry
+    int next(int state,
+             int direction) const;                // next state or MOVE_AUTOMATON_PRUNED (start state is 0)
+    static int getDirection(int width,
+                            int blank,
+                            int pos);             // direction of empty cell move (MOVE_*)
+    int getStatesCnt() const;
+    int getSequencesCnt() const;                  // count of pruned sequences
+private:
+    std::vector<int> _next;                       // state * 4 + direction => next state
+    int _sequencesCnt;
+
+    void __build(int width,
+                 int height,
+                 int depth);                      // find duplicate sequences up to depth moves and build automaton
+    static std::string __effect(const std::string &moves,
+                                int *bounds);     // tiles moved by sequence, bounds of empty cell path
+};
+
+#include "MoveAutomaton.hpp"
+
+#endif // MOVE_AUTOMATON_H
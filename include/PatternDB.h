@@ -0,0 +1,91 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PATTERN_DB_H
+#define PATTERN_DB_H
+
+#include "Board.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define PDB_GROUP_SIZE_DEFAULT 6              // tiles in a group of default partition
+#define PDB_STATES_MAX (1ULL << 31)           // max states (pattern positions x empty cell) while building one group
+#define PDB_COST_UNKNOWN 0xFF
+#define PDB_FILE_MAGIC "15PDB1"
+
+/**
+ * Additive disjoint pattern databases
+ *
+ * Tiles are split into groups (partition like "6-6-3" takes tiles 1..6, 7..12 and 13..15),
+ * each group has a table: positions of it's tiles => minimal count of moves of these tiles
+ * needed to reach a goal. Moves of other tiles are free, so costs of groups can be added
+ *
+ * Tables are built by backward breadth-first search from a goal state
+ *
+ */
+class PatternDB
+{
+public:
+    PatternDB(int width,
+              int height,
+              const std::string partition);   // empty partition means groups of PDB_GROUP_SIZE_DEFAULT tiles
+    bool isNotNull();                         // check if partition is valid
+    bool build(const int * const goal);       // build tables for goal (value => flat position)
+    bool load(const std::string path,
+              const int * const goal);        // load tables built for the same goal
+    bool save(const std::string path);        // save tables into file
+    int getWidth();
+    int getHeight();
+    int getGroupsCnt();
+    int getGroup(int value);                  // group of tile (-1 for empty cell)
+    int getCost(int group,
+                const int * const tilePos);   // cost of group, tilePos is value => flat position
+private:
+    struct Group
+    {
+        std::vector<int> tiles;               // tiles of group
+        std::vector<uint64_t> multipliers;    // weight of i-th tile position in rank
+        std::vector<unsigned char> costs;     // rank of tiles positions => cost
+    };
+
+    int _width;
+    int _height;
+    int _size;
+    std::vector<int> _goal;                   // value => flat position in a goal state
+    std::vector<int> _groupOf;                // value => group
+    std::vector<Group> _groups;
+
+    uint64_t __rank(const Group &group,
+                    const int * const positions);  // rank of group tiles positions (i-th tile => position)
+    void __unrank(const Group &group,
+                  uint64_t rank,
+                  int * const positions);          // positions of group tiles by rank
+    bool __buildGroup(Group &group,
+                      const MoveTable *moveTable); // backward BFS for one group
+};
+
+#include "PatternDB.hpp"
+
+#endif // PATTERN_DB_H
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * PatternDB::getGroup
+ *
+ * Return group of tile (-1 for empty cell)
+ *
+ */
+inline int PatternDB::getGroup(int value)
+{
+    return _groupOf[value];
+}
+
+/**
+ * PatternDB::__rank
+ *
+ * Rank of group tiles positions in the table of k-permutations
+ * Position of i-th tile is counted among positions not taken by previous tiles
+ *
+ * Example (4x4 board, group of tiles 1, 2):
+ *
+ * positions = [0,1] => rank = 0 * 15 + 0 = 0
+ * positions = [1,0] => rank = 1 * 15 + 0 = 15
+ * positions = [3,5] => rank = 3 * 15 + 4 = 49
+ *
+ */
+inline uint64_t PatternDB::__rank(const Group &group, const int * const positions)
+{
+    uint64_t rank = 0;
+    uint64_t taken = 0;
+    for ( unsigned int i = 0; i < group.tiles.size(); i++ )
+    {
+        int pos = positions[i];
+        int digit = pos - __builtin_popcountll(taken & ((1ULL << pos) - 1));
+        taken |= 1ULL << pos;
+        rank += digit * group.multipliers[i];
+    }
+    return rank;
+}
+
+/**
+ * PatternDB::getCost
+ *
+ * Cost of group for tiles positions (tilePos is value => flat position)
+ * This method is unsave!!!
+ * Because of Solver class performance it doesn't check input params
+ *
+ */
+inline int PatternDB::getCost(int group, const int * const tilePos)
+{
+    const Group &g = _groups[group];
+    int positions[BOARD_CELLS_MAX];
+    for ( unsigned int i = 0; i < g.tiles.size(); i++ )
+        positions[i] = tilePos[g.tiles[i]];
+    return g.costs[__rank(g, positions)];
+}
@@ -25,9 +25,36 @@
 #ifndef SOLVER_H
 #define SOLVER_H
 
+#include "Arena.h"
 #include "Board.h"
+#include "MoveAutomaton.h"
+#include "PatternDB.h"
+#include "WalkingDistance.h"
+#include <atomic>
 #include <sys/time.h>
 #include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#define SOLUTION_LENGTH_MAX 1024                   // max count of steps in solution (path depth)
+
+#define HEURISTIC_MANHATTAN 0                      // sum of Manhattan distances
+#define HEURISTIC_PDB       1                      // additive disjoint pattern databases
+#define HEURISTIC_LINEAR_CONFLICT 2                // Manhattan distance of tiles plus linear conflicts
+#define HEURISTIC_WALKING_DISTANCE 3               // walking distance of rows plus walking distance of columns
+
+/**
+ * Result of one solve call
+ * Workers of multi-threaded solver publish a shorter solution by compare-and-swap of the owner's steps count
+ * and keep moves in their own result, owner collects moves of the shortest one when workers are idle
+ *
+ */
+struct Solution
+{
+    std::atomic<int> stepsCnt;          // count of steps in the best solution (max int if not found)
+    std::atomic<int> foundCnt;          // count of found solutions
+    std::vector<int> shuffles;          // solution shuffles (sequence of empty cell neighbours to shuffle with)
+};
 
 /**
  * Abstract Solver
@@ -40,35 +67,75 @@ public:
     Solver(const Solver &solver);
     void dumpSolutionStates();
     void dumpSolutionShuffles();
+    void getGoal(int * const goal);                // flat position of each value in a goal state
+    bool setHeuristic(int heuristic);              // use Manhattan distance or linear conflicts as heuristic
+    bool setPatternDB(PatternDB *pdb);             // use pattern databases (built for goal) as heuristic
+    bool setWalkingDistance(WalkingDistance *wd);  // use walking distance (built for goal) as heuristic
+    void setMovePruning(bool enabled,
+                        int depth = 0);            // skip moves completing duplicate move sequences up to depth moves
+    int getStepsCount();                           // count of steps in found solution (max int if not found)
+    const std::vector<int>& getShuffles();         // solution shuffles (valid if steps count is found)
+    double getMadeStepsCount();                    // count of steps made while searching solution
+    bool isFixed();                                // board was unsolvable, so two last tiles were swapped
     virtual int solve() = 0;
     virtual ~Solver();
 private:
     void __init();                                 // init internal data
-    void __destroy();                              // destroy internal data
     void __bsIndex();                              // build board sample(goal) Index
+    void __mdIndex();                              // build Manhattan distances Index
     void __hIndex();                               // build heuristic Index
+    void __setContext(void *context);              // point search context arrays into memory block
     int __checksum();                              // calculate checksum
     void __fix();                                  // fix board if incorrect checksum
 
+    bool _fixed;                                   // two last tiles were swapped (see Solver::__fix)
     struct timeval _tv_start;
     struct timeval _tv_stop;
     double _solution_time;
 protected:
+    Arena _arena;                                  // memory of own search context and contexts of copies
     Board _board;                                  // Board object
-    static int _slnStepsCnt;                       // count of steps in solution
+    Solution _sln;                                 // result of the last solve call
     double _madeStepsCnt;                          // count of steps made while searching solution
-    static std::map<int, std::string> _slnStates;  // solution steps ( step => board state )
-    static std::vector<int> _slnShuffles;          // solution shuffles (sequence of empty cell neighbours to shuffle with)
-    static int _cpu_units;                         // number of processor units (used in multi-threaded version)
-    int **_bsIndex;                                // board sample(goal) Index
-    int  *_hIndex;                                 // heuristic Index
+    int _cpuUnits;                                 // number of processor units (used in multi-threaded version)
+    int (*_bsIndex)[2];                            // board sample(goal) Index (read only, shared with copies)
+    unsigned short *_mdIndex;                      // Manhattan distances Index (read only, shared with copies)
+    int _heuristic;                                // heuristic type (HEURISTIC_*)
+    PatternDB *_pdb;                               // pattern databases (read only, shared with copies)
+    WalkingDistance *_wd;                          // walking distance tables (read only, shared with copies)
+    const MoveAutomaton *_automaton;               // duplicate move sequences (read only, shared), NULL if disabled
+    bool _movePruning;                             // automaton should be loaded by solve
+    int _movePruningDepth;                         // length of duplicate move sequences (0 - default for geometry)
+    int  *_hIndex;                                 // heuristic Index (search context)
+    int  *_tilePos;                                // value => flat position (search context)
+    int  *_lcIndex;                                // linear conflicts of rows, then of columns (search context)
+    int  *_path;                                   // current path, depth => moved neighbour (search context)
     char _algName[64];                             // simple name of algorithm
 
-    int __stepForward(int nbr,
+    Solver(const Solver &solver,
+           void *context);                         // copy solver into preallocated search context
+    size_t __contextSize();                        // size of search context in bytes
+    void __load(const Solver &solver,
+                int depth);                        // load search state of solver into own context
+    void __resetSolution();                        // forget result of previous solve call
+    void __loadAutomaton();                        // get (build if needed) automaton of duplicate move sequences
+    bool __publishSolution(Solution &best,
+                           int G);                 // lower steps count of best solution, save path if it's shorter
+    void __saveSolution(int G);                    // save current path as a solution
+    void __saveSolution(const std::vector<int> &shuffles); // save solution longer than path (constructive solvers)
+
+    template <int Width = 0, int Height = 0>
+    int __lineConflict(int line);                  // linear conflict of a row (line < height) or column
+
+    template <int Width = 0, int Height = 0>
+    int __stepForward(int pos,
+                      int nbr,
                       int &hNbr,
                       int &hZero,
                       int &hSum);                  // swap empty cell with it's neighbour
-    void __stepBack(int nbr,
+    template <int Width = 0, int Height = 0>
+    void __stepBack(int pos,
+                    int nbr,
                     int hNbr,
                     int hZero,
                     int hSum);                     // rollback swap changes
@@ -34,28 +34,25 @@ inline void Solver::__init()
     {
         __fix();
         __bsIndex();
+        __mdIndex();
+        __setContext(_arena.allocate(__contextSize()));
         __hIndex();
     }
 }
 
 /**
- * Solver::__destroy
+ * Solver::__setContext
  *
- * Cleanup internal data
+ * Point heuristic Index, tiles positions, linear conflicts and path into one memory block
+ * (see Solver::__contextSize)
  *
  */
-inline void Solver::__destroy()
+inline void Solver::__setContext(void *context)
 {
-    if ( _board.isNotNull() )
-    {
-        // cleanup board sample index
-        for ( int x = 0; x < _board.getSize(); x++ )
-            delete [] _bsIndex[x];
-        delete [] _bsIndex;
-
-        // cleanup heuristic index
-        delete [] _hIndex;
-    }
+    _hIndex = (int*)context;
+    _tilePos = _hIndex + _board.getSize() + 1;
+    _lcIndex = _tilePos + _board.getSize();
+    _path = _lcIndex + _board.getWidth() + _board.getHeight();
 }
 
 /**
@@ -82,10 +79,8 @@ inline void Solver::__destroy()
  */
 inline void Solver::__bsIndex()
 {
-    _bsIndex = new int *[_board.getSize()];
+    _bsIndex = (int (*)[2])_arena.allocate(_board.getSize() * sizeof(*_bsIndex));
     int magick = 1;
-    for ( int x = 0; x < _board.getSize(); x++ )
-        _bsIndex[x] = new int[2];
     for ( int x = 0; x < _board.getHeight(); x++ )
     {
         for ( int y = 0; y < _board.getWidth(); y++ )
@@ -102,46 +97,268 @@ inline void Solver::__bsIndex()
     }
 }
 
+/**
+ * Solver::__mdIndex
+ *
+ * Create index of 'Manhattan distances': value * size + flat position => distance to goal position
+ * Used by kernels compiled for runtime board dimension (others use BoardGeometryTables::mdDelta)
+ *
+ */
+inline void Solver::__mdIndex()
+{
+    int size = _board.getSize();
+    int width = _board.getWidth();
+    _mdIndex = (unsigned short*)_arena.allocate(size * size * sizeof(*_mdIndex));
+    for ( int value = 0; value < size; value++ )
+    {
+        for ( int pos = 0; pos < size; pos++ )
+        {
+            _mdIndex[value * size + pos] = value ?
+                                           abs(pos / width - _bsIndex[value][0]) + abs(pos % width - _bsIndex[value][1]) : 0;
+        }
+    }
+}
+
 /**
  * Solver::__hIndex
  *
- * Create index of heuristic costs ('Manhattan distance' to a goal state)
- * The last element is a sum of all distances
- * Should be called after bsIndex created
+ * Create index of heuristic costs
+ * The last element is a sum of 'Manhattan distances' of tiles to a goal state
+ * (empty cell isn't counted, otherwise bound isn't admissible), steps update only the sum
+ * Should be called after bsIndex and mdIndex created
  *
  * Example:
  *
  * Board -> 4 1 6
  *          2 7 5
  *          0 8 3
- * hIndex[0] = 2
- * hIndex[1] = 1
- * hIndex[2] = 2
- * hIndex[3] = 2
- * hIndex[4] = 1
- * hIndex[5] = 1
- * hIndex[6] = 1
- * hIndex[7] = 2
- * hIndex[8] = 0
- * hIndex[9] = 12
+ * hIndex[9] = 1 + 2 + 2 + 1 + 1 + 1 + 2 + 0 = 10
+ *
+ * For pattern databases hIndex[i] is a cost of i-th group
+ * For walking distance hIndex[0] and hIndex[1] are states of rows and columns tables
+ * For linear conflicts empty cell isn't counted and conflicts of all lines (see Solver::__lineConflict)
+ * are added to the sum
  *
  */
 inline void Solver::__hIndex()
 {
-    int hIndexSize = _board.getSize() + 1;
-    _hIndex = new int[hIndexSize];
+    int size = _board.getSize();
+    for ( int pos = 0; pos < size; pos++ )
+        _tilePos[_board.getCell(pos)] = pos;
+    for ( int i = 0; i <= size; i++ )
+        _hIndex[i] = 0;
+
     int heuristic = 0;
-    for ( int i = 0; i < _board.getSize(); i++ )
+    if ( _heuristic == HEURISTIC_PDB )
+    {
+        for ( int group = 0; group < _pdb->getGroupsCnt(); group++ )
+        {
+            _hIndex[group] = _pdb->getCost(group, _tilePos);
+            heuristic += _hIndex[group];
+        }
+        _hIndex[size] = heuristic;
+        return;
+    }
+
+    if ( _heuristic == HEURISTIC_WALKING_DISTANCE )
+    {
+        _hIndex[0] = _wd->getIndex(true, _tilePos);
+        _hIndex[1] = _wd->getIndex(false, _tilePos);
+        _hIndex[size] = _wd->getCost(true, _hIndex[0]) + _wd->getCost(false, _hIndex[1]);
+        return;
+    }
+
+    for ( int i = 1; i < size; i++ )
+    {
+        heuristic += _mdIndex[i * size + _tilePos[i]];
+    }
+
+    int lines = _board.getWidth() + _board.getHeight();
+    for ( int line = 0; line < lines; line++ )
+    {
+        _lcIndex[line] = 0;
+        if ( _heuristic == HEURISTIC_LINEAR_CONFLICT )
+        {
+            _lcIndex[line] = __lineConflict(line);
+            heuristic += _lcIndex[line];
+        }
+    }
+    _hIndex[size] = heuristic;
+}
+
+/**
+ * Solver::__lineConflict
+ *
+ * Linear conflict of a line: tiles which are in their goal line, but in a reversed order,
+ * can't pass each other without leaving the line, so each tile out of the longest
+ * ordered subsequence costs two extra moves to Manhattan distance
+ * line < height is a row, otherwise a column (line - height)
+ * Width and Height are board dimensions known while compiling (0 if they are known only at runtime)
+ *
+ * Return 2 * (count of tiles in their goal line - longest increasing subsequence of their goal positions)
+ *
+ */
+template <int Width, int Height>
+inline int Solver::__lineConflict(int line)
+{
+    int width = Width ? Width : _board.getWidth();
+    int height = Height ? Height : _board.getHeight();
+    bool row = line < height;
+    int first = row ? line * width : line - height;
+    int step = row ? 1 : width;
+    int len = row ? width : height;
+    if ( ! row )
+    {
+        line -= height;
+    }
+
+    // tails[k] - minimal goal position ending ordered subsequence of length k + 1
+    int tails[len];
+    int tailsCnt = 0;
+    int tilesCnt = 0;
+    for ( int pos = first, i = 0; i < len; pos += step, i++ )
     {
-        int dx, dy = 0;
-        _board.getValueXY(i, dx, dy);
-        int x = _bsIndex[i][0];
-        int y = _bsIndex[i][1];
-        int h = abs(dx - x) + abs(dy - y);
-        heuristic += h;
-        _hIndex[i] = h;
+        int value = _board.getCell<Width, Height>(pos);
+        if ( ! value )
+        {
+            continue;
+        }
+        int goalLine, goalPos;
+        if constexpr ( Width > 0 )
+        {
+            const BoardGeometryTables<Width, Height> &g = BoardGeometry<Width, Height>::tables;
+            goalLine = row ? g.goalX[value] : g.goalY[value];
+            goalPos = row ? g.goalY[value] : g.goalX[value];
+        }
+        else
+        {
+            goalLine = _bsIndex[value][row ? 0 : 1];
+            goalPos = _bsIndex[value][row ? 1 : 0];
+        }
+        if ( goalLine != line )
+        {
+            continue;
+        }
+        tilesCnt++;
+        int k = 0;
+        while ( k < tailsCnt && tails[k] < goalPos )
+            k++;
+        tails[k] = goalPos;
+        if ( k == tailsCnt )
+        {
+            tailsCnt++;
+        }
     }
-    _hIndex[_board.getSize()] = heuristic;
+    return 2 * (tilesCnt - tailsCnt);
+}
+
+/**
+ * Solver::__contextSize
+ *
+ * Size of search context (heuristic Index, tiles positions, linear conflicts and path) in bytes
+ *
+ */
+inline size_t Solver::__contextSize()
+{
+    return (2 * _board.getSize() + 1 + _board.getWidth() + _board.getHeight() + SOLUTION_LENGTH_MAX) * sizeof(int);
+}
+
+/**
+ * Solver::__load
+ *
+ * Load search state (board, heuristic Index, tiles positions, linear conflicts and path up to depth)
+ * of solver with the same board dimension
+ * Own context is reused, so nothing is allocated
+ *
+ */
+inline void Solver::__load(const Solver &solver, int depth)
+{
+    _board = solver._board;
+    memcpy(_hIndex, solver._hIndex,
+           (2 * _board.getSize() + 1 + _board.getWidth() + _board.getHeight()) * sizeof(int));
+    memcpy(_path, solver._path, (depth + 1) * sizeof(int));
+    _madeStepsCnt = 0;
+}
+
+/**
+ * Solver::__resetSolution
+ *
+ * Forget solution, count of found solutions and count of made steps of previous solve call
+ *
+ */
+inline void Solver::__resetSolution()
+{
+    _sln.stepsCnt = std::numeric_limits<int>::max();
+    _sln.foundCnt = 0;
+    _sln.shuffles.clear();
+    _madeStepsCnt = 0;
+}
+
+/**
+ * Solver::__loadAutomaton
+ *
+ * Called by solve, if move pruning is enabled (see Solver::setMovePruning)
+ * Copies share automaton of original
+ *
+ */
+inline void Solver::__loadAutomaton()
+{
+    if ( _movePruning && ! _automaton )
+    {
+        _automaton = MoveAutomaton::get(_board.getWidth(), _board.getHeight(), _movePruningDepth);
+    }
+}
+
+/**
+ * Solver::__publishSolution
+ *
+ * Lower steps count of best solution to G by compare-and-swap (no lock), if it's longer
+ * Current path is saved into own result, so moves of concurrent solutions never overwrite each other
+ *
+ * Return true if path is the best solution
+ *
+ */
+inline bool Solver::__publishSolution(Solution &best, int G)
+{
+    best.foundCnt++;
+    int stepsCnt = best.stepsCnt.load();
+    while ( G < stepsCnt )
+    {
+        if ( best.stepsCnt.compare_exchange_weak(stepsCnt, G) )
+        {
+            _sln.stepsCnt = G;
+            _sln.shuffles.assign(_path + 1, _path + G + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Solver::__saveSolution
+ *
+ * Copy current path (moves at depths 1..G) into solution
+ * No formatting, states are rebuilt only in dumpSolutionStates
+ * (storage of solution grows only if solution is longer than any saved before)
+ * Should be called in a critical section by multi-threaded algorithms
+ *
+ */
+inline void Solver::__saveSolution(int G)
+{
+    _sln.stepsCnt = G;
+    _sln.shuffles.assign(_path + 1, _path + G + 1);
+}
+
+/**
+ * Solver::__saveSolution
+ *
+ * Save shuffles of solver which doesn't keep it's path in search context
+ *
+ */
+inline void Solver::__saveSolution(const std::vector<int> &shuffles)
+{
+    _sln.stepsCnt = shuffles.size();
+    _sln.shuffles = shuffles;
 }
 
 /**
@@ -218,6 +435,7 @@ inline void Solver::__fix()
     if ( cs & 1 )
     {
         _board.swap(size - 1, size - 2);
+        _fixed = true;
     }
 }
 
@@ -225,36 +443,113 @@ inline void Solver::__fix()
  * Solver::__stepForward
  *
  * Permutation  board on one step, where 0 is swapped with it's neighbour
+ * pos - flat position of neighbour
+ * nbr - neighbour value
+ *
+ * Width and Height are board dimensions known while compiling
+ * (0 if they are known only at runtime)
  *
  * Return new heuristic sum
  *
  */
-inline int Solver::__stepForward(int nbr, int &hNbr, int &hZero, int &hSum)
+template <int Width, int Height>
+inline int Solver::__stepForward(int pos, int nbr, int &hNbr, int &hZero, int &hSum)
 {
+    int blank = _board.getBlank();
+
+    // saved values which aren't used by heuristic
+    hNbr = 0;
+    hZero = 0;
 
     // swap board tiles
-    _board.swap(nbr, 0);
-    int size = _board.getSize();
+    _board.moveBlank<Width, Height>(pos);
+    int size = Width ? Width * Height : _board.getSize();
+
+    if ( _heuristic == HEURISTIC_PDB )
+    {
+
+        // only group of neighbour is changed
+        int group = _pdb->getGroup(nbr);
+        _tilePos[nbr] = blank;
+        hNbr = _hIndex[group];
+        hSum = _hIndex[size];
+        _hIndex[group] = _pdb->getCost(group, _tilePos);
+        _hIndex[size] += _hIndex[group] - hNbr;
+        _madeStepsCnt++;
+        return _hIndex[size];
+    }
+
+    if ( _heuristic == HEURISTIC_WALKING_DISTANCE )
+    {
+
+        // vertical move changes only rows table, horizontal - only columns table
+        bool vertical = abs(pos - blank) != 1;
+        int goalLine;
+        if constexpr ( Width > 0 )
+        {
+            const BoardGeometryTables<Width, Height> &g = BoardGeometry<Width, Height>::tables;
+            goalLine = vertical ? g.goalX[nbr] : g.goalY[nbr];
+        }
+        else
+        {
+            goalLine = _bsIndex[nbr][vertical ? 0 : 1];
+        }
+        int table = vertical ? 0 : 1;
+        hNbr = _hIndex[table];
+        hSum = _hIndex[size];
+        _hIndex[table] = _wd->getNext(vertical, hNbr, pos < blank ? WD_UP : WD_DOWN, goalLine);
+        _hIndex[size] += _wd->getCost(vertical, _hIndex[table]) - _wd->getCost(vertical, hNbr);
+        _madeStepsCnt++;
+        return _hIndex[size];
+    }
 
     // save current heuristic
-    hNbr = _hIndex[nbr];
-    hZero = _hIndex[0];
     hSum = _hIndex[size];
 
-    // recalculate heuristic after swap
-    int xsn = _bsIndex[nbr][0];
-    int ysn = _bsIndex[nbr][1];
-    int xsz = _bsIndex[0][0];
-    int ysz = _bsIndex[0][1];
+    // neighbour moved from pos to place of empty cell, empty cell isn't counted
+    if constexpr ( Width > 0 )
+    {
+        _hIndex[size] += BoardGeometry<Width, Height>::tables.mdDelta[nbr][pos][blank];
+    }
+    else
+    {
+        _hIndex[size] += _mdIndex[nbr * size + blank] - _mdIndex[nbr * size + pos];
+    }
 
-    int xn, yn = 0;
-    _board.getValueXY(nbr, xn, yn);
-    int xz, yz = 0;
-    _board.getValueXY(0, xz, yz);
+    if ( _heuristic == HEURISTIC_LINEAR_CONFLICT )
+    {
+        int xsn, ysn, xn, yn, xz, yz;
+        if constexpr ( Width > 0 )
+        {
+            const BoardGeometryTables<Width, Height> &g = BoardGeometry<Width, Height>::tables;
+            xsn = g.goalX[nbr];
+            ysn = g.goalY[nbr];
+            xn = g.cellX[blank];
+            yn = g.cellY[blank];
+            xz = g.cellX[pos];
+            yz = g.cellY[pos];
+        }
+        else
+        {
+            int width = _board.getWidth();
+            xsn = _bsIndex[nbr][0];
+            ysn = _bsIndex[nbr][1];
+            xn = blank / width;
+            yn = blank % width;
+            xz = pos / width;
+            yz = pos % width;
+        }
 
-    _hIndex[0] = abs(xz - xsz) + abs(yz - ysz);
-    _hIndex[nbr] = abs(xn - xsn) + abs(yn - ysn);
-    _hIndex[size] += _hIndex[nbr] + _hIndex[0] - hNbr - hZero;
+        // only goal line of neighbour can change and only if neighbour leaves or enters it,
+        // hZero keeps previous conflict of that line
+        int line = ( xn == xz ) ? ( Height ? Height : _board.getHeight() ) + ysn : xsn;
+        hZero = _lcIndex[line];
+        if ( ( xn == xz ) ? ( ysn == yn || ysn == yz ) : ( xsn == xn || xsn == xz ) )
+        {
+            _lcIndex[line] = __lineConflict<Width, Height>(line);
+            _hIndex[size] += _lcIndex[line] - hZero;
+        }
+    }
 
     _madeStepsCnt++;
 
@@ -265,14 +560,40 @@ inline int Solver::__stepForward(int nbr, int &hNbr, int &hZero, int &hSum)
  * Solver::__stepBack
  *
  * Rollback all changes after step forward
+ * pos - flat position of empty cell before step forward
  *
  */
-inline void Solver::__stepBack(int nbr, int hNbr, int hZero, int hSum)
+template <int Width, int Height>
+inline void Solver::__stepBack(int pos, int nbr, int hNbr, int hZero, int hSum)
 {
-    _board.swap(nbr, 0);
-    _hIndex[nbr] = hNbr;
-    _hIndex[0] = hZero;
-    _hIndex[_board.getSize()] = hSum;
+    if ( _heuristic == HEURISTIC_PDB )
+    {
+        _tilePos[nbr] = _board.getBlank();
+        _hIndex[_pdb->getGroup(nbr)] = hNbr;
+    }
+    else if ( _heuristic == HEURISTIC_WALKING_DISTANCE )
+    {
+        _hIndex[abs(pos - _board.getBlank()) == 1 ? 1 : 0] = hNbr;
+    }
+    else if ( _heuristic == HEURISTIC_LINEAR_CONFLICT )
+    {
+
+        // neighbour moved horizontally if it's positions differ by one
+        int blank = _board.getBlank();
+        int line;
+        if constexpr ( Width > 0 )
+        {
+            const BoardGeometryTables<Width, Height> &g = BoardGeometry<Width, Height>::tables;
+            line = ( abs(pos - blank) == 1 ) ? Height + g.goalY[nbr] : g.goalX[nbr];
+        }
+        else
+        {
+            line = ( abs(pos - blank) == 1 ) ? _board.getHeight() + _bsIndex[nbr][1] : _bsIndex[nbr][0];
+        }
+        _lcIndex[line] = hZero;
+    }
+    _board.moveBlank<Width, Height>(pos);
+    _hIndex[Width ? Width * Height : _board.getSize()] = hSum;
 }
 
 
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef STATE_TABLE_H
+#define STATE_TABLE_H
+
+#include "Board.h"
+#include <stdint.h>
+#include <map>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+#define STATE_TABLE_STATES_MAX (1 << 24)    // max reachable states of board (3x3 has 181440)
+#define STATE_TABLE_COST_UNKNOWN 0xFF
+
+/**
+ * Table of exact costs for the whole state space of small boards
+ *
+ * State is ranked by a perfect hash: position of empty cell * (size - 1)! / 2 + rank of tiles permutation / 2.
+ * For each position of empty cell only a half of tiles permutations are reachable and two permutations,
+ * which differ in order of the last two tiles only, have different parity, so exactly one of them is reachable
+ *
+ * Tables are built by breadth-first search from a goal state on first request
+ * and shared by all solvers in process
+ *
+ */
+class StateTable
+{
+public:
+    StateTable();
+    static const StateTable* get(int width,
+                                 int height,
+                                 const int * const goal);  // get table for goal (value => flat position)
+    int getWidth() const;
+    int getHeight() const;
+    uint32_t rank(const int * const cells) const;          // rank of state, cells is flat position => value
+    int getCost(const int * const cells) const;            // minimal count of moves to a goal
+private:
+    int _width;
+    int _height;
+    int _size;
+    uint32_t _tilesStates;                                  // (size - 1)! / 2
+    std::vector<unsigned char> _costs;                      // rank => cost
+
+    bool __build(int width,
+                 int height,
+                 const int * const goal);                   // breadth-first search from a goal state
+};
+
+#include "StateTable.hpp"
+
+#endif // STATE_TABLE_H
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * StateTable::rank
+ *
+ * Perfect hash of reachable state (cells is flat position => value)
+ * Digit of each tile is count of smaller tiles to the right of it
+ *
+ * Example (3x3):
+ *
+ * cells = [1,2,3,4,5,6,7,8,0] => rank = 8 * 20160 + 0 / 2 = 161280
+ * cells = [0,2,1,3,4,5,6,7,8] => rank = 0 * 20160 + 5040 / 2 = 2520
+ *
+ */
+inline uint32_t StateTable::rank(const int * const cells) const
+{
+    uint32_t tiles = 0;
+    uint32_t taken = 0;
+    int blank = 0;
+    int left = _size - 2;
+    for ( int pos = 0; pos < _size; pos++ )
+    {
+        int value = cells[pos];
+        if ( ! value )
+        {
+            blank = pos;
+            continue;
+        }
+
+        // smaller tiles which are not taken yet are to the right
+        int digit = value - 1 - __builtin_popcount(taken & ((1U << value) - 1));
+        taken |= 1U << value;
+        uint32_t weight = 1;
+        for ( int k = 2; k <= left; k++ )
+            weight *= k;
+        tiles += digit * weight;
+        left--;
+    }
+    return blank * _tilesStates + tiles / 2;
+}
+
+/**
+ * StateTable::getCost
+ *
+ * Minimal count of moves to a goal state (cells is flat position => value)
+ *
+ */
+inline int StateTable::getCost(const int * const cells) const
+{
+    return _costs[rank(cells)];
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+/**
+ * Transposition table of IDA* (fixed size, lock-free, shared by all workers)
+ *
+ * Each slot keeps one packed state with the least count of moves it was reached with,
+ * cost limit of search where it was reached and state of move automaton
+ * Entry is two words (state ^ data, data), so torn entry written by other thread is just a miss
+ *
+ */
+class TranspositionTable
+{
+public:
+    TranspositionTable(int mb);         // table of mb megabytes (rounded down to power of two of entries)
+    bool isNotNull();
+    size_t getSize();                   // count of entries
+    void clear();                       // forget states of previous search
+    bool visit(uint64_t state,
+               int fsm,
+               int G,
+               int F);                  // true if subtree of state should be skipped, else record state
+    ~TranspositionTable();
+private:
+    struct Entry
+    {
+        std::atomic<uint64_t> check;    // state ^ data
+        std::atomic<uint64_t> data;     // G (16 bits), F (16 bits), state of move automaton (32 bits)
+    };
+
+    Entry *_entries;
+    uint64_t _mask;                     // count of entries - 1
+};
+
+#include "TranspositionTable.hpp"
+
+#endif // TRANSPOSITION_TABLE_H
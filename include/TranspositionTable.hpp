@@ -0,0 +1,59 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * TranspositionTable::visit
+ *
+ * Subtree is skipped if state was reached with less count of moves (current path isn't optimal)
+ * or with the same count of moves, cost limit and state of move automaton
+ * (the same subtree is searched by other path)
+ * Otherwise state is recorded with current count of moves and cost limit
+ *
+ */
+inline bool TranspositionTable::visit(uint64_t state, int fsm, int G, int F)
+{
+    uint64_t slot = state ^ (state >> 29);
+    slot *= 0xbf58476d1ce4e5b9ULL;
+    slot ^= slot >> 32;
+    Entry &entry = _entries[slot & _mask];
+
+    uint64_t data = entry.data.load(std::memory_order_relaxed);
+    if ( (entry.check.load(std::memory_order_relaxed) ^ data) == state )
+    {
+        int g = data & 0xFFFF;
+        if ( G > g )
+        {
+            return true;
+        }
+        if ( G == g && (int)((data >> 16) & 0xFFFF) == F && (int)(data >> 32) == fsm )
+        {
+            return true;
+        }
+    }
+
+    data = (uint64_t)G | ((uint64_t)F << 16) | ((uint64_t)(uint32_t)fsm << 32);
+    entry.data.store(data, std::memory_order_relaxed);
+    entry.check.store(state ^ data, std::memory_order_relaxed);
+    return false;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WALKING_DISTANCE_H
+#define WALKING_DISTANCE_H
+
+#include "Board.h"
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#define WD_KEY_BITS_MAX 64                    // bits of packed table state
+#define WD_STATES_MAX (1 << 24)               // max states of one table
+#define WD_UP   0                             // empty cell moves to previous line (up or left)
+#define WD_DOWN 1                             // empty cell moves to next line (down or right)
+
+/**
+ * Walking distance (Ken'ichiro Takahashi)
+ *
+ * State of rows table is a matrix: count of tiles in row r whose goal row is g,
+ * one vertical move takes a tile with goal row g from a neighbour row of empty cell into it's row.
+ * Table keeps minimal count of vertical moves needed to reach a goal, columns table is the same
+ * for horizontal moves. Each move is either vertical or horizontal, so costs of tables can be added
+ *
+ * Square boards use one table for rows and columns
+ *
+ */
+class WalkingDistance
+{
+public:
+    WalkingDistance(int width,
+                    int height);
+    bool isNotNull();                         // check if tables were built
+    bool build(const int * const goal);       // build tables for goal (value => flat position)
+    int getWidth();
+    int getHeight();
+    int getIndex(bool rows,
+                 const int * const tilePos);  // state of rows (columns) table, tilePos is value => flat position
+    int getCost(bool rows,
+                int index);                   // cost of state
+    int getNext(bool rows,
+                int index,
+                int dir,
+                int goalLine);                // state after tile with goal line moves into line of empty cell
+private:
+    struct Table
+    {
+        int lines;                            // count of lines (rows or columns)
+        int lineLen;                          // cells in line
+        int bits;                             // bits of one counter in packed state
+        std::unordered_map<uint64_t, int> indexes;  // packed state => index
+        std::vector<unsigned char> costs;     // index => cost
+        std::vector<int> next;                // (index, dir, goal line) => index of next state
+    };
+
+    int _width;
+    int _height;
+    std::vector<int> _goal;                   // value => flat position in a goal state
+    Table _tables[2];                         // rows and columns tables
+    Table *_rows;
+    Table *_cols;
+
+    WalkingDistance(const WalkingDistance &wd);
+    WalkingDistance& operator=(const WalkingDistance &wd);
+
+    int __goalLine(bool rows,
+                   int value);                // goal row (column) of tile
+    bool __buildTable(Table &table,
+                      bool rows);             // breadth-first search from a goal state
+};
+
+#include "WalkingDistance.hpp"
+
+#endif // WALKING_DISTANCE_H
@@ -38,12 +38,23 @@
 #define ID_4x4_63      "[[12,3,13,9],[0,4,6,10],[8,2,5,15],[7,14,11,1]]"
 #define ID_4x4_58      "[[9,11,0,1],[4,14,8,12],[15,10,7,13],[5,6,2,3]]"
 
+#include "BIDA_Star.h"
+#include "Fringe_Search.h"
 #include "IDA_Star.h"
+#include "Line_Reduction.h"
+#include "Table_Descent.h"
+#include "NullLogger.h"
+#include <boost/bind/bind.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/program_options/options_description.hpp>
 #include <boost/program_options/variables_map.hpp>
 #include <boost/program_options/parsers.hpp>
+#include <atomic>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
 
 std::string head = "\
 *************************************\n\
@@ -57,10 +68,150 @@ std::string custom_puzzle;
 int width;
 int height;
 bool multi;
+bool fsm;
+int fsm_depth;
 int cpu_units;
+int frontier;
+int memory;
+int tt_memory;
+int window;
+double weight;
+double time_limit;
+bool anytime = false;
+bool allSolutions = false;
+std::string algorithm;
+std::string order;
+std::string heuristic;
+std::string pdb_partition;
+std::string pdb_file;
 bool json = false;
 bool needSolve = true;
+std::string batch_file;
 
+/**
+ * Puzzles of batch (see Board::parseAll), index of board is it's id
+ * Error is set for each invalid JSON array (empty board), it's empty for valid ones
+ *
+ */
+struct Batch
+{
+    std::vector<Board> boards;
+    std::vector<std::string> errors;
+};
+
+// heuristic tables of batch per board geometry (width, height)
+std::map<std::pair<int, int>, PatternDB*> batch_pdb;
+std::map<std::pair<int, int>, WalkingDistance*> batch_wd;
+boost::mutex batch_tables_mutex;
+boost::mutex batch_output_mutex;
+
+
+/**
+ * Create solver for board with algorithm and options from command line
+ * Transposition table (if any) is used only by IDA*
+ *
+ */
+Solver* createSolver(Board &board, int cpuUnits, TranspositionTable *tt)
+{
+    Solver *solver;
+    if ( algorithm == "table" )
+    {
+        solver = new Table_Descent(board);
+    }
+    else if ( algorithm == "lines" )
+    {
+        Line_Reduction *lines = new Line_Reduction(board);
+        lines->setWindow(window);
+        solver = lines;
+    }
+    else if ( algorithm == "fringe" )
+    {
+        Fringe_Search *fringe = new Fringe_Search(board);
+        fringe->setMemoryLimit(memory);
+        solver = fringe;
+    }
+    else if ( algorithm == "bida" )
+    {
+        BIDA_Star *bida = new BIDA_Star(board);
+        bida->setMemoryLimit(memory);
+        solver = bida;
+    }
+    else
+    {
+        IDA_Star *ida = new IDA_Star(board, cpuUnits);
+        ida->setFrontierSize(frontier);
+        ida->setAllSolutions(allSolutions);
+        if ( order == "cost" || order == "both" )
+        {
+            ida->setMoveOrdering(MOVE_ORDER_COST | (order == "both" ? MOVE_ORDER_HISTORY : 0));
+        }
+        else if ( order == "history" )
+        {
+            ida->setMoveOrdering(MOVE_ORDER_HISTORY);
+        }
+        ida->setWeight(weight);
+        ida->setAnytime(anytime);
+        ida->setTimeLimit(time_limit);
+        if ( tt )
+        {
+            ida->setTranspositionTable(tt);
+        }
+        solver = ida;
+    }
+    if ( algorithm != "lines" )
+    {
+        solver->setMovePruning(fsm, fsm_depth);
+    }
+    return solver;
+}
+
+/**
+ * Set heuristic from command line to solver
+ * Pattern databases and walking distance tables are created for board geometry only if pdb (wd) is NULL,
+ * so they may be reused by solvers of boards with the same dimension, caller deletes them
+ * Pattern database is loaded from (saved to) pdbFile, empty name disables it
+ *
+ */
+bool setupHeuristic(Solver *solver, Board &board, PatternDB *&pdb, WalkingDistance *&wd, const std::string &pdbFile)
+{
+    int goal[BOARD_CELLS_MAX];
+    if ( heuristic == "pdb" )
+    {
+        if ( ! pdb )
+        {
+            solver->getGoal(goal);
+            pdb = new PatternDB(board.getWidth(), board.getHeight(), pdb_partition);
+            if ( ! pdb->load(pdbFile, goal) )
+            {
+                if ( pdb->build(goal) )
+                {
+                    pdb->save(pdbFile);
+                }
+            }
+        }
+        return solver->setPatternDB(pdb);
+    }
+
+    if ( heuristic == "lc" )
+    {
+        return solver->setHeuristic(HEURISTIC_LINEAR_CONFLICT);
+    }
+
+    if ( heuristic == "wd" )
+    {
+        if ( ! wd )
+        {
+            solver->getGoal(goal);
+            wd = new WalkingDistance(board.getWidth(), board.getHeight());
+            if ( ! wd->build(goal) )
+            {
+                return false;
+            }
+        }
+        return solver->setWalkingDistance(wd);
+    }
+    return true;
+}
 
 /**
  * Run solver
@@ -86,7 +237,15 @@ void run()
             cpu_units = 1;
         }
 
-        Solver *solver = new IDA_Star(*board, cpu_units);
+        TranspositionTable *tt = NULL;
+        if ( tt_memory > 0 && algorithm == "ida" )
+        {
+            tt = new TranspositionTable(tt_memory);
+        }
+
+        Solver *solver = createSolver(*board, cpu_units, tt);
+        PatternDB *pdb = NULL;
+        WalkingDistance *wd = NULL;
         std::cout << "=====> Set puzzle: ";
 
         if ( json )
@@ -97,16 +256,202 @@ void run()
         std::cout << std::endl << std::endl;
         board->print();
 
-        if ( ! needSolve )
+        if ( needSolve && setupHeuristic(solver, *board, pdb, wd, pdb_file) )
         {
+            solver->solve();
+            solver->dumpSolutionShuffles();
+        }
+        delete solver;
+        delete tt;
+        delete pdb;
+        delete wd;
+    }
+    delete board;
+}
+
+/**
+ * Escape string to be put into JSON string value
+ *
+ */
+std::string jsonEscape(const std::string &s)
+{
+    std::string escaped;
+    for ( size_t i = 0; i < s.length(); i++ )
+    {
+        if ( s[i] == '"' || s[i] == '\\' )
+        {
+            escaped += '\\';
+        }
+        escaped += isprint((unsigned char)s[i]) ? s[i] : ' ';
+    }
+    return escaped;
+}
+
+/**
+ * Pattern database file of batch board
+ *
+ * Batch may mix board sizes, so WxH is inserted before extension of --pdb-file (663.pdb -> 663.4x4.pdb)
+ *
+ */
+std::string batchPdbFile(Board &board)
+{
+    if ( pdb_file.empty() )
+    {
+        return pdb_file;
+    }
+    std::stringstream geometry(std::stringstream::in | std::stringstream::out);
+    geometry << "." << board.getWidth() << "x" << board.getHeight();
+    size_t dot = pdb_file.rfind('.');
+    size_t slash = pdb_file.find_last_of("/\\");
+    if ( dot == std::string::npos || (slash != std::string::npos && dot < slash) )
+    {
+        return pdb_file + geometry.str();
+    }
+    return pdb_file.substr(0, dot) + geometry.str() + pdb_file.substr(dot);
+}
+
+/**
+ * Batch worker
+ *
+ * Take next puzzle from the list (shared counter), solve it single-threaded and print one JSON line
+ * Each solver keeps it's own solution, heuristic tables are built once per board geometry
+ *
+ */
+void batchWorker(Batch *batch, std::atomic<int> *next)
+{
+    TranspositionTable *tt = NULL;
+    if ( tt_memory > 0 && algorithm == "ida" )
+    {
+
+        // table is reused by solvers of this worker, one by one
+        tt = new TranspositionTable(tt_memory);
+    }
+
+    int i;
+    while ( (i = (*next)++) < (int)batch->boards.size() )
+    {
+        Board &board = batch->boards[i];
+        std::stringstream ss(std::stringstream::in | std::stringstream::out);
+        ss << "{\"id\":" << i;
+        if ( ! batch->errors[i].empty() )
+        {
+            ss << ",\"status\":\"error\",\"error\":\"" << jsonEscape(batch->errors[i]) << "\"}";
+        }
+        else
+        {
+            Solver *solver = createSolver(board, 1, tt && board.getSize() <= PACKED_SIZE_MAX ? tt : NULL);
+            bool ready = false;
+            if ( ! solver->isFixed() )
+            {
+                boost::mutex::scoped_lock lock(batch_tables_mutex);
+                std::pair<int, int> geometry(board.getWidth(), board.getHeight());
+                ready = setupHeuristic(solver, board, batch_pdb[geometry], batch_wd[geometry], batchPdbFile(board));
+            }
+            if ( solver->isFixed() )
+            {
+
+                // two last tiles were swapped by solver, so it's moves don't solve the given board
+                ss << ",\"status\":\"unsolvable\",\"steps\":null,\"moves\":null}";
+            }
+            else if ( ! ready )
+            {
+                ss << ",\"status\":\"error\",\"error\":\"heuristic tables are not built\"}";
+            }
+            else
+            {
+                struct timeval start, stop;
+                gettimeofday(&start, NULL);
+                solver->solve();
+                gettimeofday(&stop, NULL);
+                int steps = solver->getStepsCount();
+                const std::vector<int> &shuffles = solver->getShuffles();
+                bool solved = steps <= (int)shuffles.size();
+                ss << ",\"status\":\"" << (solved ? "solved" : "unsolved") << "\"";
+                ss << ",\"steps\":";
+                if ( solved )
+                {
+                    ss << steps << ",\"moves\":[";
+                    for ( int j = 0; j < steps; j++ )
+                    {
+                        ss << (j ? "," : "") << shuffles[j];
+                    }
+                    ss << "]";
+                }
+                else
+                {
+                    ss << "null,\"moves\":null";
+                }
+                char buf[64];
+                snprintf(buf, 64, ",\"nodes\":%.0f,\"time\":%.6f}", solver->getMadeStepsCount(),
+                         (stop.tv_sec - start.tv_sec) + (stop.tv_usec - start.tv_usec) / 1000000.0);
+                ss << buf;
+            }
             delete solver;
-            return;
         }
 
-        solver->solve();
-        solver->dumpSolutionShuffles();
-        delete solver;
+        // whole lines only, in order of completion
+        boost::mutex::scoped_lock lock(batch_output_mutex);
+        std::cout << ss.str() << std::endl;
     }
+    delete tt;
+}
+
+/**
+ * Run batch
+ *
+ * Read JSON arrays of puzzles from file (or STDIN if file is "-"), solve them by parallel workers
+ * (one puzzle per worker at a time) and print one JSON line per puzzle:
+ * {"id":0,"status":"solved","steps":31,"moves":[...],"nodes":12345,"time":0.012345}
+ * Invalid puzzle is reported as {"id":1,"status":"error","error":"..."},
+ * puzzle which can't reach a goal as {"id":2,"status":"unsolvable","steps":null,"moves":null}
+ *
+ */
+int runBatch()
+{
+    std::string input;
+    if ( batch_file == "-" )
+    {
+        input.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    }
+    else
+    {
+        std::ifstream file(batch_file.c_str(), std::ios::in | std::ios::binary);
+        if ( ! file )
+        {
+            std::cerr << "Can't read batch file " << batch_file << std::endl;
+            return 1;
+        }
+        input.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // invalid puzzle keeps it's id
+    Batch batch;
+    Board::parseAll(input.c_str(), input.length(), batch.boards, &batch.errors);
+
+    // solvers' progress would break JSON lines
+    NullLogger quiet;
+    Logger::setInstance(&quiet);
+
+    int workersCnt = multi && cpu_units > 1 ? cpu_units : 1;
+    workersCnt = std::min(workersCnt, std::max((int)batch.boards.size(), 1));
+    std::atomic<int> next(0);
+    boost::thread_group workers;
+    for ( int j = 0; j < workersCnt; j++ )
+    {
+        workers.create_thread(boost::bind(batchWorker, &batch, &next));
+    }
+    workers.join_all();
+
+    for ( std::map<std::pair<int, int>, PatternDB*>::iterator it = batch_pdb.begin(); it != batch_pdb.end(); ++it )
+    {
+        delete it->second;
+    }
+    for ( std::map<std::pair<int, int>, WalkingDistance*>::iterator it = batch_wd.begin(); it != batch_wd.end(); ++it )
+    {
+        delete it->second;
+    }
+    Logger::setInstance(NULL);
+    return 0;
 }
 
 /**
@@ -132,12 +477,51 @@ int main(int argc, char *argv[])
     ("help", "show this help message")
     ("no-solution,n", "just create and print random puzzle")
     ("json,j", "print generated puzzle in JSON format")
+    ("all-solutions,a", "don't stop at the first optimal solution, count all of them")
     ("width,w", boost::program_options::value<int>(&width)->default_value(4), "random puzzle width")
     ("height,h", boost::program_options::value<int>(&height)->default_value(4), "random puzzle height")
     ("set-puzzle,c", boost::program_options::value<std::string>(&custom_puzzle)->default_value(""), "set custom puzzle where arg is JSON array")
+    ("batch,b", boost::program_options::value<std::string>(&batch_file)->default_value(""),
+     "solve JSON arrays of puzzles from file arg (- for STDIN) by parallel workers (see cpu-units), "
+     "one puzzle per worker, and print one JSON line per puzzle with steps, moves, nodes and time")
     ("multi,m", boost::program_options::value<bool>(&multi)->default_value(true), "use multi-threaded version of algotithm")
+    ("fsm", boost::program_options::value<bool>(&fsm)->default_value(true),
+     "skip moves completing duplicate move sequences (finite state machine)")
+    ("fsm-depth", boost::program_options::value<int>(&fsm_depth)->default_value(0),
+     "max length of duplicate move sequences (up to 12), longer ones prune more nodes, but take more time to find, "
+     "0 - 10 for boards like 4x4, 8 for others")
     ("cpu-units,u", boost::program_options::value<int>(&cpu_units)->default_value(boost::thread::hardware_concurrency()),
-     "used in multi-threaded algorithm\nSet it only if auto detected value is incorrect");
+     "used in multi-threaded algorithm\nSet it only if auto detected value is incorrect")
+    ("frontier,f", boost::program_options::value<int>(&frontier)->default_value(0),
+     "multi-threaded algorithm expands root breadth-first to at least arg nodes (ex. 10000) "
+     "and searches them as independent jobs\nBy default subtrees are shared between threads on demand")
+    ("algorithm,g", boost::program_options::value<std::string>(&algorithm)->default_value("ida"),
+     "algorithm: ida (IDA*) | bida (bidirectional IDA*, boards up to 16 cells) | "
+     "fringe (fringe search, IDA* continued from states exceeding limit, boards up to 16 cells) | "
+     "table (descent over exact costs of all states, small boards only, ex. 3x3) | "
+     "lines (rows and columns are placed one at a time, not optimal, any board, ex. 20x20)")
+    ("window", boost::program_options::value<int>(&window)->default_value(0),
+     "lines algorithm replaces each arg moves of solution with the shortest path if found (ex. 16), 0 - don't shorten")
+    ("memory", boost::program_options::value<int>(&memory)->default_value(0),
+     "memory in MB for states near a goal (bida algorithm, 64 by default) "
+     "or for stored states (fringe algorithm, 256 by default, IDA* is used when it's over)")
+    ("order,o", boost::program_options::value<std::string>(&order)->default_value("none"),
+     "order of children in IDA*: none | cost (less cost first) | history (moves close to limit in previous iterations first) | both")
+    ("tt-memory", boost::program_options::value<int>(&tt_memory)->default_value(0),
+     "memory in MB for transposition table of IDA* (boards up to 16 cells, not used with -a), 0 - don't use table")
+    ("weight", boost::program_options::value<double>(&weight)->default_value(1),
+     "weight of heuristic in IDA*, solution is found faster on large boards (ex. 5x5), "
+     "but it's length is at most arg * optimal")
+    ("anytime", "IDA* repeats weighted search with less weight while time allows, the best solution is kept")
+    ("time-limit", boost::program_options::value<double>(&time_limit)->default_value(0),
+     "stop IDA* after arg seconds and keep the best found solution, 0 - no limit\n"
+     "Time is counted from the start of solution and includes build of move automaton (see fsm)")
+    ("heuristic,e", boost::program_options::value<std::string>(&heuristic)->default_value("manhattan"),
+     "heuristic: manhattan | lc (linear conflicts) | wd (walking distance) | pdb (additive pattern databases)")
+    ("pdb-partition", boost::program_options::value<std::string>(&pdb_partition)->default_value(""),
+     "tiles count in each pattern database group, ex. 6-6-3\nBy default groups of 6 tiles")
+    ("pdb-file", boost::program_options::value<std::string>(&pdb_file)->default_value(""),
+     "load pattern databases from file (built and saved there if missing)");
 
     boost::program_options::variables_map vm;
 
@@ -168,6 +552,46 @@ int main(int argc, char *argv[])
         json = true;
     }
 
+    if ( vm.count("all-solutions") )
+    {
+        allSolutions = true;
+    }
+
+    if ( vm.count("anytime") )
+    {
+        anytime = true;
+    }
+
+    if ( algorithm != "ida" && algorithm != "bida" && algorithm != "table" && algorithm != "lines"
+         && algorithm != "fringe" )
+    {
+        showHelp(desc);
+        return 1;
+    }
+
+    if ( weight < 1 )
+    {
+        showHelp(desc);
+        return 1;
+    }
+
+    if ( order != "none" && order != "cost" && order != "history" && order != "both" )
+    {
+        showHelp(desc);
+        return 1;
+    }
+
+    if ( heuristic != "manhattan" && heuristic != "lc" && heuristic != "wd" && heuristic != "pdb" )
+    {
+        showHelp(desc);
+        return 1;
+    }
+
+    if ( batch_file.length() )
+    {
+        return runBatch();
+    }
+
     std::cout << head << std::endl;
 
     run();
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Arena.h"
+#include <stdlib.h>
+#include <new>
+
+/**
+ * Arena constructor
+ *
+ * No memory is taken until first allocation
+ *
+ */
+Arena::Arena(size_t chunkSize)
+{
+    _chunkSize = chunkSize;
+    _used = 0;
+    _capacity = 0;
+}
+
+/**
+ * Arena::allocate
+ *
+ * Return block of at least size bytes aligned to a cache line
+ * New chunk is taken from system only if current one is full
+ *
+ */
+void* Arena::allocate(size_t size)
+{
+    size = (size + ARENA_CACHE_LINE - 1) & ~((size_t)ARENA_CACHE_LINE - 1);
+    if ( _used + size > _capacity )
+    {
+        size_t capacity = size > _chunkSize ? size : _chunkSize;
+        void *chunk = NULL;
+        if ( posix_memalign(&chunk, ARENA_CACHE_LINE, capacity) )
+        {
+            throw std::bad_alloc();
+        }
+        _chunks.push_back((char*)chunk);
+        _capacity = capacity;
+        _used = 0;
+    }
+    void *block = _chunks.back() + _used;
+    _used += size;
+    return block;
+}
+
+/**
+ * Arena destructor
+ *
+ * Release all chunks
+ *
+ */
+Arena::~Arena()
+{
+    for ( unsigned int i = 0; i < _chunks.size(); i++ )
+    {
+        free(_chunks[i]);
+    }
+}
@@ -0,0 +1,311 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "BIDA_Star.h"
+#include "Logger.h"
+#include <stdlib.h>
+
+/**
+ * BIDA_Star constructor
+ *
+ */
+BIDA_Star::BIDA_Star(Board &board) : Solver(board)
+{
+    // Initialized in a base class
+    _stack = (Frame*)_arena.allocate((SOLUTION_LENGTH_MAX + 1) * sizeof(Frame));
+    _memoryLimit = (size_t)BIDA_MEMORY_DEFAULT << 20;
+    _mask = 0;
+    _perimeter = -1;
+    _perimeterCnt = 0;
+    strcpy(_algName, "BIDA*");
+}
+
+/**
+ * BIDA_Star::setMemoryLimit
+ *
+ * Memory for states of goal perimeter in MB
+ * More memory gives deeper perimeter, so forward search is shallower
+ *
+ */
+void BIDA_Star::setMemoryLimit(int mb)
+{
+    if ( mb > 0 )
+    {
+        _memoryLimit = (size_t)mb << 20;
+    }
+}
+
+/**
+ * BIDA_Star::__kernel
+ *
+ * Choose search kernel compiled for board dimension
+ * Boards of other dimensions use generic kernel
+ *
+ */
+BIDA_Star::Iteration BIDA_Star::__kernel()
+{
+    int width = _board.getWidth();
+    int height = _board.getHeight();
+    if ( width == 3 && height == 3 )
+        return &BIDA_Star::__iteration<3, 3>;
+    if ( width == 3 && height == 4 )
+        return &BIDA_Star::__iteration<3, 4>;
+    if ( width == 4 && height == 3 )
+        return &BIDA_Star::__iteration<4, 3>;
+    if ( width == 4 && height == 4 )
+        return &BIDA_Star::__iteration<4, 4>;
+    return &BIDA_Star::__iteration<0, 0>;
+}
+
+/**
+ * BIDA_Star::__buildPerimeter
+ *
+ * Backward breadth-first search from a goal, level by level
+ * States of the next level are found by scanning hash for states of current level
+ * Hash is filled at most by half, if a level doesn't fit into it, it's states are marked as unknown
+ * (they stay in hash, but lookup doesn't use them), so perimeter is always a complete set of levels
+ * Each made move is counted in made steps, as moves of IDA* iterations
+ *
+ */
+bool BIDA_Star::__buildPerimeter()
+{
+    int width = _board.getWidth();
+    int height = _board.getHeight();
+    int size = _board.getSize();
+    if ( size > PACKED_SIZE_MAX )
+    {
+        Logger::getInstance().errorAt("BIDA_Star::__buildPerimeter")
+        .explain("board is too large for bidirectional search ")
+        .append(width).append("x").append(height).endl();
+        return false;
+    }
+
+    uint64_t slots = 1;
+    while ( (slots << 1) * (sizeof(uint64_t) + 1) <= _memoryLimit )
+    {
+        slots <<= 1;
+    }
+    _mask = slots - 1;
+    _keys.assign(slots, 0);
+    _depths.assign(slots, BIDA_DEPTH_UNKNOWN);
+
+    int goal[size];
+    getGoal(goal);
+    uint64_t state = 0;
+    for ( int value = 1; value < size; value++ )
+    {
+        state |= (uint64_t)value << (goal[value] * PACKED_CELL_BITS);
+    }
+    __insert(state, 0);
+    _parity.resize(size);
+    for ( int pos = 0; pos < size; pos++ )
+    {
+        _parity[pos] = (abs(pos / width - goal[0] / width) + abs(pos % width - goal[0] % width)) & 1;
+    }
+    _perimeter = 0;
+    _perimeterCnt = 1;
+
+    const MoveTable *moveTable = Board::getMoveTable(width, height);
+    size_t statesMax = slots / 2;
+    size_t levelCnt = 1;
+    while ( levelCnt && _perimeter < BIDA_DEPTH_UNKNOWN - 1 )
+    {
+        levelCnt = 0;
+        bool full = false;
+        for ( uint64_t slot = 0; slot < slots && ! full; slot++ )
+        {
+            if ( ! _keys[slot] || _depths[slot] != _perimeter )
+            {
+                continue;
+            }
+            state = _keys[slot];
+            int blank = 0;
+            while ( (state >> (blank * PACKED_CELL_BITS)) & PACKED_CELL_MASK )
+            {
+                blank++;
+            }
+            const int *moves = &moveTable->moves[blank * NEIGHBOURS_CNT_MAX];
+            for ( int i = 0; i < moveTable->movesCnt[blank]; i++ )
+            {
+                if ( _perimeterCnt + levelCnt >= statesMax )
+                {
+                    full = true;
+                    break;
+                }
+                int pos = moves[i];
+                uint64_t value = (state >> (pos * PACKED_CELL_BITS)) & PACKED_CELL_MASK;
+                uint64_t next = state - (value << (pos * PACKED_CELL_BITS)) + (value << (blank * PACKED_CELL_BITS));
+                _madeStepsCnt++;
+                if ( __insert(next, _perimeter + 1) )
+                {
+                    levelCnt++;
+                }
+            }
+        }
+
+        if ( full )
+        {
+
+            // level doesn't fit into memory
+            for ( uint64_t slot = 0; slot < slots; slot++ )
+            {
+                if ( _keys[slot] && _depths[slot] == _perimeter + 1 )
+                {
+                    _depths[slot] = BIDA_DEPTH_UNKNOWN;
+                }
+            }
+            break;
+        }
+        if ( levelCnt )
+        {
+            _perimeter++;
+            _perimeterCnt += levelCnt;
+        }
+    }
+    return true;
+}
+
+/**
+ * BIDA_Star::__descend
+ *
+ * Append moves from perimeter state to a goal into current path (depths G+1..G+depth),
+ * each move leads to a state of perimeter one move closer to a goal
+ *
+ */
+void BIDA_Star::__descend(uint64_t state, int G, int depth)
+{
+    const MoveTable *moveTable = Board::getMoveTable(_board.getWidth(), _board.getHeight());
+    for ( ; depth > 0; depth-- )
+    {
+        int blank = 0;
+        while ( (state >> (blank * PACKED_CELL_BITS)) & PACKED_CELL_MASK )
+        {
+            blank++;
+        }
+        const int *moves = &moveTable->moves[blank * NEIGHBOURS_CNT_MAX];
+        for ( int i = 0; i < moveTable->movesCnt[blank]; i++ )
+        {
+            int pos = moves[i];
+            uint64_t value = (state >> (pos * PACKED_CELL_BITS)) & PACKED_CELL_MASK;
+            uint64_t next = state - (value << (pos * PACKED_CELL_BITS)) + (value << (blank * PACKED_CELL_BITS));
+            if ( __find(next) == depth - 1 )
+            {
+                _path[++G] = value;
+                state = next;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * BIDA_Star::solve
+ *
+ * Bidirectional IDA* search: perimeter of a goal is built once,
+ * then IDA* iterations search from the root until they meet perimeter
+ * Cost of states outside of perimeter is at least perimeter depth + 1
+ *
+ * Return minimal count of moves needed for solution
+ *
+ */
+int BIDA_Star::solve()
+{
+    if ( ! _board.isNotNull() )
+    {
+        return 0;
+    }
+    __resetSolution();
+
+    Logger::getInstance().append(_algName).append(" started, ").timestamp();
+
+    __mStart();
+    __loadAutomaton();
+
+    int F = 0;
+    if ( __buildPerimeter() )
+    {
+        Logger::getInstance() << "Perimeter depth => " << _perimeter
+                              << " (" << _perimeterCnt << " states)";
+        Logger::getInstance().endl();
+
+        // heuristic sum
+        F = _hIndex[_board.getSize()];
+        int depth = __find(_board.getPacked());
+        if ( depth != BIDA_DEPTH_UNKNOWN )
+        {
+
+            // start is in perimeter
+            __descend(_board.getPacked(), 0, depth);
+            __saveSolution(depth);
+            F = 0;
+        }
+        else if ( F <= _perimeter )
+        {
+            F = _perimeter + 1 + ((_perimeter + 1 + _parity[_board.getBlank()]) & 1);
+        }
+    }
+    Logger::getInstance() << "F => " << F << " ";
+
+    Iteration iteration = __kernel();
+    while ( F )
+    {
+        if ( F >= SOLUTION_LENGTH_MAX )
+        {
+            Logger::getInstance().endl().errorAt("BIDA_Star::solve")
+            .explain("cost limit exceeds max solution length ")
+            .append(SOLUTION_LENGTH_MAX).endl();
+            break;
+        }
+        F = (this->*iteration)(F);
+        Logger::getInstance() << F << " ";
+    }
+
+    __mStop();
+
+    // release perimeter
+    std::vector<uint64_t>().swap(_keys);
+    std::vector<unsigned char>().swap(_depths);
+
+    Logger::getInstance().endl();
+    Logger::getInstance().append(_algName).append(" stopped, ").timestamp();
+    Logger::getInstance().append("-----------------------").endl();
+    Logger::getInstance().append("Minimal steps count: ")
+    .append(_sln.stepsCnt.load()).endl();
+    Logger::getInstance().append("Made permutations  : ")
+    .append(this->_madeStepsCnt).endl();
+    char buf[128];
+    snprintf(buf, 128, "Solution time      : %.6f sec", __getSlnUsec()/1000000);
+    Logger::getInstance().append(buf).append(" (");
+    __getSlnTime(buf);
+    Logger::getInstance().append(buf).append(")").endl();
+    return _sln.stepsCnt;
+}
+
+/**
+ * BIDA_Star destructor
+ *
+ */
+BIDA_Star::~BIDA_Star()
+{
+}
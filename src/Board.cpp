@@ -23,6 +23,7 @@
  */
 
 #include "Board.h"
+#include <ctype.h>
 #include <sstream>
 #include <stdio.h>
 
@@ -34,7 +35,8 @@
  */
 Board::Board(int width, int height)
 {
-    _board = NULL;
+    _size = 0;
+    _moveTable = NULL;
     if ( width > 1 && height > 1 )
     {
         _width  = width;
@@ -58,7 +60,6 @@ Board::Board(int width, int height)
  */
 Board::Board()
 {
-    _board  = NULL;
     _width  = BOARD_WIDTH;
     _height = BOARD_HEIGHT;
     _size = _width * _height;
@@ -73,66 +74,42 @@ Board::Board()
  */
 Board::Board(const std::string json)
 {
+    int cells[BOARD_CELLS_MAX];
     int width, height = 0;
-    int **board = __parse(json, width, height);
-    if ( board )
+    std::string error;
+    _size = 0;
+    _moveTable = NULL;
+    if ( parse(json.c_str(), json.length(), cells, width, height, &error) )
     {
-        _board = board;
         _width = width;
         _height = height;
         _size = width * height;
-        __init();
+        __load(cells);
     }
     else
     {
-        _board = NULL;
+        Logger::getInstance().errorAt("Board::parse")
+        .explain(error).endl();
     }
 }
 
 /**
- * Board copy constructor
+ * Board constructor
  *
- * Duplicate board internal data
+ * Create board from flat cells, which are already validated (see Board::parse)
+ * Board isn't created if cells are NULL (see Board::parseAll)
  *
  */
-Board::Board(const Board &board)
+Board::Board(const int * const cells, int width, int height)
 {
-    *this = board;
-
-    // copy board
-    _board = new int *[board._height];
-    for ( int x = 0; x < board._height; x++ )
-    {
-        _board[x] = new int[board._width];
-        for ( int y = 0; y < board._width; y++ )
-            _board[x][y] = board._board[x][y];
-    }
-
-    // copy bIndex
-    _bIndex = new int *[board._size];
-    for ( int x = 0; x < board._size; x++ )
-    {
-        _bIndex[x] = new int[2];
-        _bIndex[x][0] = board._bIndex[x][0];
-        _bIndex[x][1] = board._bIndex[x][1];
-    }
-
-    // copy nIndex
-    _nIndex = new int **[board._size];
-    for ( int x = 0; x < board._size; x++ )
+    _width = width;
+    _height = height;
+    _size = 0;
+    _moveTable = NULL;
+    if ( cells )
     {
-        _nIndex[x] = new int *[NEIGHBOURS_CNT_MAX];
-        for ( int n = 0; n < NEIGHBOURS_CNT_MAX; n++ )
-        {
-            if ( board._nIndex[x][n] )
-            {
-                _nIndex[x][n] = &_board[_bIndex[*board._nIndex[x][n]][0]][_bIndex[*board._nIndex[x][n]][1]];
-            }
-            else
-            {
-                _nIndex[x][n] = 0;
-            }
-        }
+        _size = width * height;
+        __load(cells);
     }
 }
 
@@ -179,7 +156,7 @@ int Board::getSize()
  */
 int Board::getValue(int x, int y)
 {
-    return _board[x][y];
+    return getCell(x * _width + y);
 }
 
 /**
@@ -192,8 +169,9 @@ int Board::getValue(int x, int y)
  */
 void Board::getValueXY(int value, int &x, int &y)
 {
-    x = _bIndex[value][0];
-    y = _bIndex[value][1];
+    int pos = __findCell(value);
+    x = pos / _width;
+    y = pos % _width;
 }
 
 /**
@@ -206,16 +184,10 @@ void Board::getValueXY(int value, int &x, int &y)
  */
 void Board::swap(int a, int b)
 {
-    _board[_bIndex[a][0]][_bIndex[a][1]] = _board[_bIndex[b][0]][_bIndex[b][1]];
-    _board[_bIndex[b][0]][_bIndex[b][1]] = a;
-
-    int *bi = _bIndex[a];
-    _bIndex[a] = _bIndex[b];
-    _bIndex[b] = bi;
-
-    int **ni = _nIndex[a];
-    _nIndex[a] = _nIndex[b];
-    _nIndex[b] = ni;
+    int posA = __findCell(a);
+    int posB = __findCell(b);
+    __setCell(posA, b);
+    __setCell(posB, a);
 }
 
 /**
@@ -230,12 +202,304 @@ void Board::swap(int a, int b)
  */
 int Board::getNeigbours(int value, int * const nbrs)
 {
-    int i;
-    for ( i = 0; i < NEIGHBOURS_CNT_MAX && _nIndex[value][i]; i++)
+    int pos = __findCell(value);
+    const int *m = &_moveTable->moves[pos * NEIGHBOURS_CNT_MAX];
+    int cnt = _moveTable->movesCnt[pos];
+    for ( int i = 0; i < cnt; i++ )
+        nbrs[i] = getCell(m[i]);
+    return cnt;
+}
+
+/**
+ * Board::parse
+ *
+ * Parse string like "[[1,2,3],[4,5,6],[7,8,0]]" into flat cells in a single pass
+ * cells should have space for BOARD_CELLS_MAX values, nothing is allocated
+ * (error message is copied only if board is invalid and error is set)
+ *
+ * Return count of consumed characters (0 if board is invalid)
+ *
+ */
+int Board::parse(const char *json, int length, int * const cells, int &width, int &height, std::string *error)
+{
+    char reason[128];
+    int i = 0;
+    int size = 0;
+    int rows = 0;
+    int rowWidth = 0;
+    width = 0;
+    height = 0;
+
+    // skip leading spaces
+    while ( i < length && isspace(json[i]) )
+        i++;
+    if ( i == length )
+    {
+        if ( error )
+            *error = "param is null";
+        return 0;
+    }
+    if ( json[i++] != ARRAY_START_CHAR )
+    {
+        snprintf(reason, sizeof(reason), "expected '%c' at %d", ARRAY_START_CHAR, i - 1);
+        goto failed;
+    }
+
+    // rows
+    for ( ;; )
     {
-        nbrs[i] = *_nIndex[value][i];
+        while ( i < length && isspace(json[i]) )
+            i++;
+        if ( i == length || json[i] != ARRAY_START_CHAR )
+        {
+            snprintf(reason, sizeof(reason), "expected '%c' at %d", ARRAY_START_CHAR, i);
+            goto failed;
+        }
+        i++;
+
+        // row values
+        rowWidth = 0;
+        for ( ;; )
+        {
+            while ( i < length && isspace(json[i]) )
+                i++;
+            int sign = 1;
+            if ( i < length && json[i] == '-' )
+            {
+                sign = -1;
+                i++;
+            }
+            if ( i == length || ! isdigit(json[i]) )
+            {
+                snprintf(reason, sizeof(reason), "illegal integer at %d", i);
+                goto failed;
+            }
+            int n = 0;
+            while ( i < length && isdigit(json[i]) )
+            {
+                if ( n < BOARD_CELLS_MAX )
+                    n = n * 10 + json[i] - '0';
+                i++;
+            }
+            if ( size == BOARD_CELLS_MAX )
+            {
+                snprintf(reason, sizeof(reason), "board has more than %d cells", BOARD_CELLS_MAX);
+                goto failed;
+            }
+            cells[size++] = sign * n;
+            rowWidth++;
+            while ( i < length && isspace(json[i]) )
+                i++;
+            if ( i < length && json[i] == ARRAY_ELEM_SPLITTER_CHAR )
+            {
+                i++;
+                continue;
+            }
+            if ( i < length && json[i] == ARRAY_END_CHAR )
+            {
+                i++;
+                break;
+            }
+            snprintf(reason, sizeof(reason), "expected '%c' or '%c' at %d", ARRAY_ELEM_SPLITTER_CHAR, ARRAY_END_CHAR, i);
+            goto failed;
+        }
+        if ( ! rows )
+        {
+            width = rowWidth;
+        }
+        if ( rowWidth != width )
+        {
+            snprintf(reason, sizeof(reason), "row %d contains %d values, but previous width = %d", rows, rowWidth, width);
+            goto failed;
+        }
+        rows++;
+
+        while ( i < length && isspace(json[i]) )
+            i++;
+        if ( i < length && json[i] == ARRAY_ELEM_SPLITTER_CHAR )
+        {
+            i++;
+            continue;
+        }
+        if ( i < length && json[i] == ARRAY_END_CHAR )
+        {
+            i++;
+            break;
+        }
+        snprintf(reason, sizeof(reason), "expected '%c' or '%c' at %d", ARRAY_ELEM_SPLITTER_CHAR, ARRAY_END_CHAR, i);
+        goto failed;
+    }
+    height = rows;
+
+    // check if board (width x height) has all values filled
+    if ( ! check(cells, width, height, error) )
+    {
+        return 0;
     }
     return i;
+
+failed:
+    if ( error )
+        *error = reason;
+    return 0;
+}
+
+/**
+ * Board::check
+ *
+ * Check if flat cells of board (width x height) contain each value from 0 to width * height - 1 once
+ * Reason of failure is written into error (if not NULL)
+ *
+ */
+bool Board::check(const int * const cells, int width, int height, std::string *error)
+{
+    char reason[128];
+    if ( width < 2 || height < 2 )
+    {
+        snprintf(reason, sizeof(reason), "minimal board dimension is 2x2");
+        goto failed;
+    }
+    if ( width * height > BOARD_CELLS_MAX )
+    {
+        snprintf(reason, sizeof(reason), "board has more than %d cells", BOARD_CELLS_MAX);
+        goto failed;
+    }
+    {
+        int size = width * height;
+        uint64_t seen[BOARD_CELLS_MAX / 64] = {0};
+        for ( int pos = 0; pos < size; pos++ )
+        {
+            int value = cells[pos];
+            if ( value < 0 || value >= size )
+            {
+                snprintf(reason, sizeof(reason), "%d is out of range", value);
+                goto failed;
+            }
+            if ( seen[value >> 6] & (1ULL << (value & 63)) )
+            {
+                snprintf(reason, sizeof(reason), "%d is duplicated", value);
+                goto failed;
+            }
+            seen[value >> 6] |= 1ULL << (value & 63);
+        }
+    }
+    return true;
+
+failed:
+    if ( error )
+        *error = reason;
+    return false;
+}
+
+/**
+ * Board::parseAll
+ *
+ * Parse many JSON arrays from one buffer and append boards to a list
+ * Arrays may be separated by spaces, new lines or commas
+ * Invalid board is skipped up to the end of line, it's reported into log,
+ * or if errors is not NULL, an empty board is appended in it's place (so index of board is it's id)
+ * and reason is appended to errors (empty string for each valid board)
+ *
+ * Return count of parsed valid boards
+ *
+ */
+int Board::parseAll(const char *json, int length, std::vector<Board> &boards, std::vector<std::string> *errors)
+{
+    int cells[BOARD_CELLS_MAX];
+    int parsed = 0;
+    int i = 0;
+    while ( i < length )
+    {
+        if ( isspace(json[i]) || json[i] == ARRAY_ELEM_SPLITTER_CHAR )
+        {
+            i++;
+            continue;
+        }
+        int width, height = 0;
+        std::string error;
+        int consumed = parse(json + i, length - i, cells, width, height, &error);
+        if ( consumed )
+        {
+            boards.push_back(Board(cells, width, height));
+            parsed++;
+            i += consumed;
+        }
+        else
+        {
+            if ( errors )
+            {
+                boards.push_back(Board(NULL, 0, 0));
+            }
+            else
+            {
+                Logger::getInstance().errorAt("Board::parseAll")
+                .explain(error).endl();
+            }
+            while ( i < length && json[i] != '\n' )
+                i++;
+        }
+        if ( errors )
+        {
+            errors->push_back(error);
+        }
+    }
+    return parsed;
+}
+
+/**
+ * Board::getMoveTable
+ *
+ * Get moves of empty cell for board geometry
+ * Table is built on first request and shared by all boards (and solver copies)
+ * with the same dimension
+ *
+ * Example (3x3):
+ *
+ * Positions -> 0 1 2
+ *              3 4 5
+ *              6 7 8
+ * moves[0] = [1,3]
+ * moves[4] = [3,1,5,7]
+ * moves[8] = [7,5]
+ *
+ */
+const MoveTable* Board::getMoveTable(int width, int height)
+{
+    static std::map<std::pair<int, int>, MoveTable> tables;
+    static boost::mutex tablesMutex;
+
+    // critical section
+    boost::mutex::scoped_lock lock(tablesMutex);
+    std::pair<int, int> geometry(width, height);
+    std::map<std::pair<int, int>, MoveTable>::iterator it = tables.find(geometry);
+    if ( it != tables.end() )
+    {
+        return &it->second;
+    }
+
+    int size = width * height;
+    MoveTable &table = tables[geometry];
+    table.moves.assign(size * NEIGHBOURS_CNT_MAX, -1);
+    table.movesCnt.assign(size, 0);
+    for ( int pos = 0; pos < size; pos++ )
+    {
+        int x = pos / width;
+        int y = pos % width;
+        int *m = &table.moves[pos * NEIGHBOURS_CNT_MAX];
+
+        // left, up, right, down
+        int cnt = 0;
+        if ( y > 0 )
+            m[cnt++] = pos - 1;
+        if ( x > 0 )
+            m[cnt++] = pos - width;
+        if ( y < width - 1 )
+            m[cnt++] = pos + 1;
+        if ( x < height - 1 )
+            m[cnt++] = pos + width;
+        table.movesCnt[pos] = cnt;
+    }
+    return &table;
 }
 
 /**
@@ -245,14 +509,14 @@ int Board::getNeigbours(int value, int * const nbrs)
  */
 void Board::print()
 {
-    if ( _board )
+    if ( _size )
     {
         char num_buf[8];
         for ( int i = 0; i < _height; i++ )
         {
             for ( int j = 0; j < _width; j++ )
             {
-                snprintf(num_buf, 8, "%4d", _board[i][j]);
+                snprintf(num_buf, 8, "%4d", getValue(i, j));
                 Logger::getInstance() << num_buf;
             }
             Logger::getInstance().endl();
@@ -269,7 +533,7 @@ void Board::print()
  */
 std::string Board::toString()
 {
-    if ( _board )
+    if ( _size )
     {
         std::stringstream ss(std::stringstream::in | std::stringstream::out);
         ss << ARRAY_START_CHAR;
@@ -278,7 +542,7 @@ std::string Board::toString()
             ss << ARRAY_START_CHAR;
             for (int y = 0; y < _width; y++ )
             {
-                ss << _board[x][y] << ARRAY_ELEM_SPLITTER_CHAR;
+                ss << getValue(x, y) << ARRAY_ELEM_SPLITTER_CHAR;
             }
             int pos = ss.tellp();
             ss.seekp(pos - 1);
@@ -291,7 +555,7 @@ std::string Board::toString()
     }
     else
     {
-        return NULL;
+        return std::string();
     }
 }
 
@@ -304,7 +568,7 @@ std::string Board::toString()
  */
 bool Board::isNotNull()
 {
-    return _board ? true : false;
+    return _size ? true : false;
 }
 
 /**
@@ -316,7 +580,7 @@ bool Board::isNotNull()
  */
 void Board::dumpIndexes()
 {
-    if ( _board )
+    if ( _size )
     {
         int bs = 32;
         char buf[bs];
@@ -325,8 +589,8 @@ void Board::dumpIndexes()
         {
             snprintf(buf, bs, "%2d: ", i);
             Logger::getInstance() << buf;
-            int x = _bIndex[i][0];
-            int y = _bIndex[i][1];
+            int x, y = 0;
+            getValueXY(i, x, y);
             snprintf(buf, bs, "%c%2d,%2d%c\n", ARRAY_START_CHAR, x, y, ARRAY_END_CHAR);
             Logger::getInstance() << buf;
         }
@@ -335,9 +599,11 @@ void Board::dumpIndexes()
         {
             snprintf(buf, bs, "%2d: %c", i, ARRAY_START_CHAR);
             Logger::getInstance() << buf;
-            for ( int n = 0; n < NEIGHBOURS_CNT_MAX && _nIndex[i][n]; n++)
+            int nbrs[NEIGHBOURS_CNT_MAX];
+            int cnt = getNeigbours(i, nbrs);
+            for ( int n = 0; n < cnt; n++ )
             {
-                snprintf(buf, bs, "%p -> %2d, ", _nIndex[i][n], *_nIndex[i][n]);
+                snprintf(buf, bs, "%2d, ", nbrs[n]);
                 Logger::getInstance() << buf;
             }
             snprintf(buf, bs, "\b\b%c\n", ARRAY_END_CHAR);
@@ -346,12 +612,3 @@ void Board::dumpIndexes()
         Logger::getInstance().endl();
     }
 }
-
-/**
- * Board destructor
- *
- */
-Board::~Board()
-{
-    __destroy();
-}
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Fifteen_API.h"
+#include "BIDA_Star.h"
+#include "Fringe_Search.h"
+#include "IDA_Star.h"
+#include "Line_Reduction.h"
+#include "NullLogger.h"
+#include "Table_Descent.h"
+#include <algorithm>
+#include <map>
+#include <string.h>
+#include <sys/time.h>
+#include <boost/thread/mutex.hpp>
+
+/**
+ * Get walking distance tables for board geometry
+ * Tables are built on first request and shared by all solutions with the same dimension
+ *
+ * Return NULL if tables can't be built for geometry
+ *
+ */
+static WalkingDistance* getWalkingDistance(Solver *solver, int width, int height)
+{
+    static std::map<std::pair<int, int>, WalkingDistance*> tables;
+    static boost::mutex tablesMutex;
+
+    boost::mutex::scoped_lock lock(tablesMutex);
+    std::pair<int, int> geometry(width, height);
+    std::map<std::pair<int, int>, WalkingDistance*>::iterator it = tables.find(geometry);
+    if ( it == tables.end() )
+    {
+        int goal[BOARD_CELLS_MAX];
+        solver->getGoal(goal);
+        WalkingDistance *wd = new WalkingDistance(width, height);
+        if ( ! wd->build(goal) )
+        {
+            delete wd;
+            wd = NULL;
+        }
+        it = tables.insert(std::make_pair(geometry, wd)).first;
+    }
+    return it->second;
+}
+
+/**
+ * Create solver of board with algorithm from options
+ * Search algorithms skip duplicate move sequences if movePruning is set
+ *
+ * Return NULL if algorithm is unknown
+ *
+ */
+static Solver* createSolver(Board &board, const fifteen_options &options)
+{
+    Solver *solver;
+    switch ( options.algorithm )
+    {
+        case FIFTEEN_ALGORITHM_IDA:
+        {
+            IDA_Star *ida = new IDA_Star(board, options.threads > 1 ? options.threads : 1);
+            ida->setWeight(options.weight);
+            ida->setTimeLimit(options.timeLimit);
+            solver = ida;
+            break;
+        }
+        case FIFTEEN_ALGORITHM_BIDA:
+        {
+            BIDA_Star *bida = new BIDA_Star(board);
+            bida->setMemoryLimit(options.memory);
+            solver = bida;
+            break;
+        }
+        case FIFTEEN_ALGORITHM_FRINGE:
+        {
+            Fringe_Search *fringe = new Fringe_Search(board);
+            fringe->setMemoryLimit(options.memory);
+            solver = fringe;
+            break;
+        }
+        case FIFTEEN_ALGORITHM_TABLE:
+            solver = new Table_Descent(board);
+            break;
+        case FIFTEEN_ALGORITHM_LINES:
+        {
+            Line_Reduction *lines = new Line_Reduction(board);
+            lines->setWindow(options.window);
+            return lines;
+        }
+        default:
+            return NULL;
+    }
+    solver->setMovePruning(options.movePruning != 0);
+    return solver;
+}
+
+/**
+ * Set heuristic from options to solver
+ *
+ */
+static bool setHeuristic(Solver *solver, Board &board, const fifteen_options &options)
+{
+    switch ( options.heuristic )
+    {
+        case FIFTEEN_HEURISTIC_MANHATTAN:
+            return true;
+        case FIFTEEN_HEURISTIC_LINEAR_CONFLICT:
+            return solver->setHeuristic(HEURISTIC_LINEAR_CONFLICT);
+        case FIFTEEN_HEURISTIC_WALKING_DISTANCE:
+        {
+            WalkingDistance *wd = getWalkingDistance(solver, board.getWidth(), board.getHeight());
+            return wd && solver->setWalkingDistance(wd);
+        }
+    }
+    return false;
+}
+
+/**
+ * fifteen_default_options
+ *
+ * IDA* with Manhattan distance in calling thread, no limits, duplicate move sequences are skipped
+ *
+ */
+void fifteen_default_options(fifteen_options *options)
+{
+    options->size = sizeof(fifteen_options);
+    options->algorithm = FIFTEEN_ALGORITHM_IDA;
+    options->heuristic = FIFTEEN_HEURISTIC_MANHATTAN;
+    options->threads = 1;
+    options->weight = 1;
+    options->timeLimit = 0;
+    options->memory = 0;
+    options->window = 0;
+    options->movePruning = 1;
+}
+
+/**
+ * fifteen_solve
+ *
+ * Solver logs into NullLogger of calling thread (workers of IDA* don't log),
+ * so console of application is left untouched
+ *
+ * Return FIFTEEN_* status
+ *
+ */
+int fifteen_solve(const int *tiles, int width, int height, const fifteen_options *options,
+                  int *moves, int movesSize, fifteen_result *result)
+{
+    static NullLogger quiet;
+    fifteen_options defaults;
+    fifteen_result own;
+    if ( ! options )
+    {
+        fifteen_default_options(&defaults);
+        options = &defaults;
+    }
+    if ( ! result )
+    {
+        result = &own;
+    }
+    memset(result, 0, sizeof(*result));
+
+    if ( ! tiles || ! Board::check(tiles, width, height) )
+    {
+        result->status = FIFTEEN_INVALID;
+        return result->status;
+    }
+    if ( options->size != (int)sizeof(fifteen_options) || options->weight < 1 )
+    {
+        result->status = FIFTEEN_BAD_OPTIONS;
+        return result->status;
+    }
+
+    Logger *previous = Logger::setThreadInstance(&quiet);
+    Board board(tiles, width, height);
+    Solver *solver = createSolver(board, *options);
+    if ( ! solver )
+    {
+        result->status = FIFTEEN_BAD_OPTIONS;
+    }
+    else if ( solver->isFixed() )
+    {
+        result->status = FIFTEEN_UNSOLVABLE;
+    }
+    else if ( ! setHeuristic(solver, board, *options) )
+    {
+        result->status = FIFTEEN_BAD_OPTIONS;
+    }
+    else
+    {
+        struct timeval start, stop;
+        gettimeofday(&start, NULL);
+        solver->solve();
+        gettimeofday(&stop, NULL);
+        result->time = (stop.tv_sec - start.tv_sec) + (stop.tv_usec - start.tv_usec) / 1000000.0;
+        result->nodesCnt = solver->getMadeStepsCount();
+
+        int steps = solver->getStepsCount();
+        const std::vector<int> &shuffles = solver->getShuffles();
+        if ( steps > (int)shuffles.size() )
+        {
+            result->status = FIFTEEN_NOT_FOUND;
+        }
+        else
+        {
+            result->stepsCnt = steps;
+            if ( steps > movesSize || ( steps && ! moves ) )
+            {
+                result->status = FIFTEEN_BUFFER_TOO_SMALL;
+            }
+            else
+            {
+                result->status = FIFTEEN_OK;
+                std::copy(shuffles.begin(), shuffles.begin() + steps, moves);
+            }
+        }
+    }
+    delete solver;
+    Logger::setThreadInstance(previous);
+    return result->status;
+}
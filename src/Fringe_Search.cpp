@@ -0,0 +1,198 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Fringe_Search.h"
+#include "IDA_Star.h"
+#include "Logger.h"
+#include <algorithm>
+
+/**
+ * Fringe_Search constructor
+ *
+ */
+Fringe_Search::Fringe_Search(Board &board) : Solver(board)
+{
+    // Initialized in a base class
+    _memoryLimit = (size_t)FRINGE_MEMORY_DEFAULT << 20;
+    _mask = 0;
+    _head = -1;
+    strcpy(_algName, "Fringe search");
+}
+
+/**
+ * Fringe_Search::setMemoryLimit
+ *
+ * Memory for stored states in MB (each state takes about 40 bytes with it's slots of hash)
+ *
+ */
+void Fringe_Search::setMemoryLimit(int mb)
+{
+    if ( mb > 0 )
+    {
+        _memoryLimit = (size_t)mb << 20;
+    }
+}
+
+/**
+ * Fringe_Search::__kernel
+ *
+ * Choose search kernel compiled for board dimension
+ * Boards of other dimensions use generic kernel
+ *
+ */
+Fringe_Search::Search Fringe_Search::__kernel()
+{
+    int width = _board.getWidth();
+    int height = _board.getHeight();
+    if ( width == 3 && height == 3 )
+        return &Fringe_Search::__search<3, 3>;
+    if ( width == 3 && height == 4 )
+        return &Fringe_Search::__search<3, 4>;
+    if ( width == 4 && height == 3 )
+        return &Fringe_Search::__search<4, 3>;
+    if ( width == 4 && height == 4 )
+        return &Fringe_Search::__search<4, 4>;
+    return &Fringe_Search::__search<0, 0>;
+}
+
+/**
+ * Fringe_Search::__savePath
+ *
+ * Path is rebuilt from node back to the root, moved tile is the one which took place of empty cell of parent
+ *
+ */
+int Fringe_Search::__savePath(int node)
+{
+    int G = 0;
+    for ( int n = node; _nodes[n].parent >= 0; n = _nodes[n].parent )
+    {
+        G++;
+    }
+    for ( int n = node, depth = G; depth > 0; n = _nodes[n].parent, depth-- )
+    {
+        int blank = _nodes[_nodes[n].parent].blank;
+        _path[depth] = (_nodes[n].state >> (blank * PACKED_CELL_BITS)) & PACKED_CELL_MASK;
+    }
+    __saveSolution(G);
+    return G;
+}
+
+/**
+ * Fringe_Search::__reset
+ *
+ */
+void Fringe_Search::__reset()
+{
+    std::vector<Node>().swap(_nodes);
+    std::vector<int>().swap(_slots);
+    _branch.clear();
+    _head = -1;
+}
+
+/**
+ * Fringe_Search::solve
+ *
+ * Hash grows while it's filled by half, memory limit is shared by the largest hash and nodes
+ * Boards larger than PACKED_SIZE_MAX cells and searches which don't fit into memory are solved by IDA*
+ *
+ * Return minimal count of moves needed for solution
+ *
+ */
+int Fringe_Search::solve()
+{
+    if ( ! _board.isNotNull() )
+    {
+        return 0;
+    }
+    __resetSolution();
+
+    Logger::getInstance().append(_algName).append(" started, ").timestamp();
+
+    __mStart();
+
+    int steps = -1;
+    size_t slots = 1;
+    while ( (slots << 1) * (sizeof(int) + sizeof(Node) / 2) <= _memoryLimit )
+    {
+        slots <<= 1;
+    }
+    if ( _board.getSize() <= PACKED_SIZE_MAX && slots > 1 )
+    {
+
+        // nodes are reserved, but memory is used only when they are stored
+        _mask = std::min(slots, (size_t)FRINGE_SLOTS_MIN) - 1;
+        _slots.assign(_mask + 1, -1);
+        _nodes.reserve(slots / 2);
+        steps = (this->*__kernel())();
+    }
+    size_t storedCnt = _nodes.size();
+    __reset();
+
+    __mStop();
+
+    Logger::getInstance().endl();
+    if ( steps < 0 )
+    {
+        if ( _board.getSize() > PACKED_SIZE_MAX )
+        {
+            Logger::getInstance().append("board is too large for fringe, ");
+        }
+        else
+        {
+            Logger::getInstance().append("memory is over (").append(storedCnt).append(" states), ");
+        }
+        Logger::getInstance().append("search is restarted by IDA*").endl();
+        IDA_Star ida(*this);
+        ida.solve();
+        _madeStepsCnt += ida.getMadeStepsCount();
+        if ( ida.getStepsCount() <= (int)ida.getShuffles().size() )
+        {
+            __saveSolution(ida.getShuffles());
+        }
+        return _sln.stepsCnt;
+    }
+
+    Logger::getInstance().append(_algName).append(" stopped, ").timestamp();
+    Logger::getInstance().append("-----------------------").endl();
+    Logger::getInstance().append("Minimal steps count: ")
+    .append(_sln.stepsCnt.load()).endl();
+    Logger::getInstance().append("Made permutations  : ")
+    .append(this->_madeStepsCnt).endl();
+    Logger::getInstance().append("Stored states      : ")
+    .append(storedCnt).endl();
+    char buf[128];
+    snprintf(buf, 128, "Solution time      : %.6f sec", __getSlnUsec()/1000000);
+    Logger::getInstance().append(buf).append(" (");
+    __getSlnTime(buf);
+    Logger::getInstance().append(buf).append(")").endl();
+    return _sln.stepsCnt;
+}
+
+/**
+ * Fringe_Search destructor
+ *
+ */
+Fringe_Search::~Fringe_Search()
+{
+}
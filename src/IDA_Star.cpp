@@ -26,10 +26,6 @@
 #include <stdio.h>
 #include <string.h>
 
-// declaration of static variables (should be seen from all threads)
-int IDA_Star::_slnFoundCnt = 0;
-boost::mutex IDA_Star::_sln_mutex;
-
 /**
  * IDA_Star constructor
  *
@@ -39,6 +35,21 @@ boost::mutex IDA_Star::_sln_mutex;
 IDA_Star::IDA_Star(Board &board, int cpuUnits) : Solver(board, cpuUnits)
 {
     // Initialized in a base class
+    _pool = NULL;
+    _workerId = 0;
+    _frontierSize = 0;
+    _allSolutions = false;
+    _tt = NULL;
+    _moveOrder = MOVE_ORDER_NONE;
+    _weight = 1;
+    _anytime = false;
+    _timeLimit = 0;
+    _costWeight = 1;
+    _upperBound = std::numeric_limits<int>::max();
+    _deadline = 0;
+    _ticks = 0;
+    _timedOut = false;
+    __initStack();
     if ( cpuUnits > 1 )
     {
         strcpy(_algName, "IDA* multi-threaded");
@@ -58,6 +69,175 @@ IDA_Star::IDA_Star(Board &board, int cpuUnits) : Solver(board, cpuUnits)
 IDA_Star::IDA_Star(const Solver &solver) : Solver(solver)
 {
     // Copied in a base class
+    _pool = NULL;
+    _workerId = 0;
+    _frontierSize = 0;
+    _allSolutions = false;
+    _tt = NULL;
+    _moveOrder = MOVE_ORDER_NONE;
+    _weight = 1;
+    _anytime = false;
+    _timeLimit = 0;
+    _costWeight = 1;
+    _upperBound = std::numeric_limits<int>::max();
+    _deadline = 0;
+    _ticks = 0;
+    _timedOut = false;
+    __initStack();
+}
+
+/**
+ * IDA_Star copy constructor
+ *
+ * Copy solver into search context preallocated from original's arena
+ *
+ */
+IDA_Star::IDA_Star(const IDA_Star &solver, void *context) : Solver(solver, context)
+{
+    // Copied in a base class
+    _pool = NULL;
+    _workerId = 0;
+    _frontierSize = 0;
+    _allSolutions = solver._allSolutions;
+    _tt = solver._tt;
+    _moveOrder = solver._moveOrder;
+    _weight = solver._weight;
+    _anytime = solver._anytime;
+    _timeLimit = solver._timeLimit;
+    _costWeight = solver._costWeight;
+    _upperBound = solver._upperBound;
+    _deadline = solver._deadline;
+    _ticks = 0;
+    _timedOut = false;
+    __initStack();
+}
+
+/**
+ * IDA_Star::setFrontierSize
+ *
+ * Multi-threaded version expands root breadth-first until a level has at least size nodes,
+ * then nodes of this level are searched as independent jobs with own cost bounds (AIDA*)
+ * 0 means subtrees are shared between workers on demand
+ *
+ */
+void IDA_Star::setFrontierSize(int size)
+{
+    _frontierSize = size;
+}
+
+/**
+ * IDA_Star::setAllSolutions
+ *
+ * Keep searching after the first optimal solution is found,
+ * so all optimal solutions are counted (see "Found solutions")
+ * By default search (all workers of multi-threaded version) stops at the first one
+ *
+ */
+void IDA_Star::setAllSolutions(bool all)
+{
+    _allSolutions = all;
+}
+
+/**
+ * IDA_Star::setTranspositionTable
+ *
+ * States are keyed by packed cells, so only boards up to PACKED_SIZE_MAX cells are supported
+ * Table is cleared before each search, one table shouldn't be used by solvers working at the same time
+ * It isn't used when all solutions are searched, different optimal paths reach the same states
+ *
+ */
+bool IDA_Star::setTranspositionTable(TranspositionTable *tt)
+{
+    if ( ! tt || ! tt->isNotNull() || _board.getSize() > PACKED_SIZE_MAX )
+    {
+        Logger::getInstance().errorAt("IDA_Star::setTranspositionTable")
+        .explain("transposition table is empty or board is too large").endl();
+        return false;
+    }
+    _tt = tt;
+    return true;
+}
+
+/**
+ * IDA_Star::setMoveOrdering
+ *
+ * Children ordered by cost reach a goal earlier in the last iteration,
+ * but each of them is made twice (for ordering and for search) if it isn't pruned
+ * History of moves is collected in all iterations of one solution
+ *
+ */
+void IDA_Star::setMoveOrdering(int order)
+{
+    _moveOrder = order;
+}
+
+/**
+ * IDA_Star::setWeight
+ *
+ * Heuristic multiplied by weight makes search greedier, so a solution is found much faster
+ * on large boards, but it's length is only guaranteed to be at most weight * optimal length
+ *
+ */
+bool IDA_Star::setWeight(double weight)
+{
+    if ( weight < 1 )
+    {
+        Logger::getInstance().errorAt("IDA_Star::setWeight")
+        .explain("weight of heuristic should be at least 1").endl();
+        return false;
+    }
+    _weight = weight;
+    return true;
+}
+
+/**
+ * IDA_Star::setAnytime
+ *
+ * After each found solution search is repeated with weight closer to 1 (see IDA_Star::solve),
+ * paths which can't be shorter than the best found solution are pruned
+ * Use it with time limit, search with weight 1 proves optimality and may be too long
+ *
+ */
+void IDA_Star::setAnytime(bool anytime)
+{
+    _anytime = anytime;
+}
+
+/**
+ * IDA_Star::setTimeLimit
+ *
+ * Search is stopped when limit is reached, the best solution found before is kept
+ * Limit starts in solve and covers everything done there, including build of move automaton
+ * (see Solver::setMovePruning) and frontier of multi-threaded version
+ *
+ */
+void IDA_Star::setTimeLimit(double seconds)
+{
+    _timeLimit = seconds;
+}
+
+/**
+ * IDA_Star::__kernel
+ *
+ * Choose search kernel compiled for board dimension
+ * Boards of other dimensions use generic kernel
+ *
+ */
+IDA_Star::Iteration IDA_Star::__kernel()
+{
+    int width = _board.getWidth();
+    int height = _board.getHeight();
+    if ( width == 3 && height == 3 )
+        return &IDA_Star::__iteration<3, 3>;
+    if ( width == 3 && height == 4 )
+        return &IDA_Star::__iteration<3, 4>;
+    if ( width == 4 && height == 3 )
+        return &IDA_Star::__iteration<4, 3>;
+    if ( width == 4 && height == 4 )
+        return &IDA_Star::__iteration<4, 4>;
+    if ( width == 5 && height == 5 )
+        return &IDA_Star::__iteration<5, 5>;
+    return &IDA_Star::__iteration<0, 0>;
 }
 
 /**
@@ -65,6 +245,10 @@ IDA_Star::IDA_Star(const Solver &solver) : Solver(solver)
  *
  * Realization of IDA* (Iterative Deepening A* ) search algorithm
  * Performs a series of depth-first searches with succesively increased cost-bounds
+ * Multi-threaded version creates a pool of workers once and reuses it in all iterations
+ * Weighted version (see IDA_Star::setWeight) stops at the first solution, anytime version repeats search
+ * with weight 1 + (weight - 1) / 2 until weight is 1 or time is over, each search prunes paths
+ * which can't improve the best found solution, so search without any path left proves it's optimal
  *
  * Return minimal count of moves needed for solution
  *
@@ -75,34 +259,113 @@ int IDA_Star::solve()
     {
         return 0;
     }
-    Solver::_slnStepsCnt = std::numeric_limits<int>::max();
-    IDA_Star::_slnFoundCnt = 0;
+    __resetSolution();
+    memset(_history, 0, _board.getSize() * NEIGHBOURS_CNT_MAX * sizeof(unsigned int));
 
     Logger::getInstance().append(_algName).append(" started, ").timestamp();
 
     __mStart();
+    _deadline = 0;
+    _timedOut = false;
+    if ( _timeLimit > 0 )
+    {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        _deadline = (double)tv.tv_sec * 1000000 + tv.tv_usec + _timeLimit * 1000000;
+    }
+    if ( _allSolutions )
+    {
+
+        // different solutions are duplicate sequences of each other
+        _automaton = NULL;
+    }
+    else
+    {
+
+        // built within time limit
+        __loadAutomaton();
+    }
 
     // heuristic sum
-    int F = _hIndex[_board.getSize()];
-    if ( ! F )
+    int H = _hIndex[_board.getSize()];
+    bool done = ! H;
+    if ( done )
     {
 
         // already in a goal state
-        Solver::_slnStepsCnt = 0;
+        _sln.stepsCnt = 0;
+    }
+    if ( _cpuUnits > 1 && ! done )
+    {
+        __startPool();
+        if ( _frontierSize > 0 && __buildFrontier() )
+        {
+
+            // solution is shorter than frontier depth
+            done = true;
+        }
     }
-    Logger::getInstance() << "F => " << F << " ";
 
-    while ( F )
+    Iteration iteration = __kernel();
+    double weight = _weight;
+    double bound = done ? 1 : 0;        // found solution is at most bound * optimal (0 - nothing found)
+    while ( ! done )
     {
-        if ( Solver::_cpu_units > 1 )
+        __setSearch(weight, _sln.stepsCnt);
+        int F = __cost(0, H);
+        if ( _weight > 1 )
         {
-            __DFS_Multi(F, 1, 0, &F, NULL);
+            Logger::getInstance() << "weight " << weight << ", ";
         }
-        else
+        Logger::getInstance() << "F => " << F << " ";
+
+        while ( F )
         {
-            F = __DFS(F, 1, 0, NULL);
+            if ( F >= SOLUTION_LENGTH_MAX )
+            {
+                if ( _sln.stepsCnt == _upperBound )
+                {
+
+                    // every path is pruned by found solution, so it's optimal
+                    bound = 1;
+                    break;
+                }
+                Logger::getInstance().endl().errorAt("IDA_Star::solve")
+                .explain("cost limit exceeds max solution length ")
+                .append(SOLUTION_LENGTH_MAX).endl();
+                break;
+            }
+            F = (this->*iteration)(F);
+            if ( __isTimedOut() )
+            {
+                Logger::getInstance() << "time is over ";
+                break;
+            }
+            if ( F < std::numeric_limits<int>::max() )
+            {
+                Logger::getInstance() << F << " ";
+            }
         }
-        Logger::getInstance() << F << " ";
+
+        if ( ! F )
+        {
+            bound = weight;
+        }
+        if ( F || bound <= 1 || ! _anytime || __isTimedOut() )
+        {
+            break;
+        }
+        weight = 1 + (weight - 1) / 2;
+        if ( weight - 1 < IDA_WEIGHT_STEP_MIN )
+        {
+            weight = 1;
+        }
+        Logger::getInstance().endl();
+    }
+
+    if ( _pool )
+    {
+        __stopPool();
     }
 
     __mStop();
@@ -110,16 +373,44 @@ int IDA_Star::solve()
     Logger::getInstance().endl();
     Logger::getInstance().append(_algName).append(" stopped, ").timestamp();
     Logger::getInstance().append("-----------------------").endl();
-    Logger::getInstance().append("Minimal steps count: ")
-    .append(Solver::_slnStepsCnt).endl();
+    char buf[128];
+    if ( _sln.stepsCnt > (int)_sln.shuffles.size() )
+    {
+
+        // time limit or cost limit was reached before any solution
+        Logger::getInstance().append("Minimal steps count: no solution found").endl();
+    }
+    else
+    {
+        Logger::getInstance().append("Minimal steps count: ")
+        .append(_sln.stepsCnt.load()).endl();
+    }
     Logger::getInstance().append("Made permutations  : ")
     .append(this->_madeStepsCnt).endl();
     Logger::getInstance().append("Found solutions    : ")
-    .append(IDA_Star::_slnFoundCnt).endl();
-    char buf[128];
+    .append(_sln.foundCnt.load()).endl();
+    if ( _weight > 1 && bound )
+    {
+        snprintf(buf, 128, "Weight             : %.3f (solution is at most weight * optimal)", bound);
+        Logger::getInstance().append(buf).endl();
+    }
     snprintf(buf, 128, "Solution time      : %.6f sec", __getSlnUsec()/1000000);
     Logger::getInstance().append(buf).append(" (");
     __getSlnTime(buf);
     Logger::getInstance().append(buf).append(")").endl();
-    return Solver::_slnStepsCnt;
+    return _sln.stepsCnt;
+}
+
+/**
+ * IDA_Star destructor
+ *
+ * Workers are destroyed by solver which created the pool
+ *
+ */
+IDA_Star::~IDA_Star()
+{
+    if ( _pool && _pool->owner == this )
+    {
+        __stopPool();
+    }
 }
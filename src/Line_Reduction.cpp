@@ -0,0 +1,632 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Line_Reduction.h"
+#include "Logger.h"
+#include <algorithm>
+#include <limits>
+#include <stdlib.h>
+
+/**
+ * Line_Reduction constructor
+ *
+ */
+Line_Reduction::Line_Reduction(Board &board) : Solver(board)
+{
+    // Initialized in a base class
+    _window = 0;
+    _moveTable = NULL;
+    _blank = 0;
+    _stampId = 0;
+    _nodes = 0;
+    strcpy(_algName, "Line reduction");
+}
+
+/**
+ * Line_Reduction::setWindow
+ *
+ * Each window of solution (moves count) is replaced with the shortest path between it's end states
+ * if such path is found within LINE_WINDOW_NODES_MAX states
+ *
+ */
+void Line_Reduction::setWindow(int moves)
+{
+    _window = moves;
+}
+
+/**
+ * Line_Reduction::solve
+ *
+ * Tiles of the top row or the left column of unsolved part are moved into their places
+ * one at a time (longer side first, so unsolved part stays square), until 2x2 corner is left
+ * Solution isn't optimal, but it's found in near-linear time even for 30x30 boards
+ *
+ * Return count of moves in solution
+ *
+ */
+int Line_Reduction::solve()
+{
+    if ( ! _board.isNotNull() )
+    {
+        return 0;
+    }
+    __resetSolution();
+
+    Logger::getInstance().append(_algName).append(" started, ").timestamp();
+
+    __mStart();
+
+    int size = _board.getSize();
+    int goal[size];
+    getGoal(goal);
+    _moveTable = Board::getMoveTable(_board.getWidth(), _board.getHeight());
+    _goalValue.assign(size, 0);
+    for ( int value = 0; value < size; value++ )
+    {
+        _goalValue[goal[value]] = value;
+    }
+    _locked.assign(size, 0);
+    _stamp.assign(size, 0);
+    _stampId = 0;
+    _from.assign(size, 0);
+    _queue.assign(size, 0);
+    _moves.clear();
+    __load();
+
+    if ( __reduce() )
+    {
+        Logger::getInstance().append("Constructed steps  : ").append(_moves.size()).endl();
+        if ( _window > 1 )
+        {
+            __shorten();
+        }
+        __saveSolution(_moves);
+    }
+    else
+    {
+        Logger::getInstance().errorAt("Line_Reduction::solve")
+        .explain("puzzle can't be solved").endl();
+    }
+
+    __mStop();
+
+    Logger::getInstance().append(_algName).append(" stopped, ").timestamp();
+    Logger::getInstance().append("-----------------------").endl();
+    Logger::getInstance().append("Minimal steps count: ")
+    .append(_sln.stepsCnt.load()).endl();
+    Logger::getInstance().append("Made permutations  : ")
+    .append(this->_madeStepsCnt).endl();
+    char buf[128];
+    snprintf(buf, 128, "Solution time      : %.6f sec", __getSlnUsec()/1000000);
+    Logger::getInstance().append(buf).append(" (");
+    __getSlnTime(buf);
+    Logger::getInstance().append(buf).append(")").endl();
+    return _sln.stepsCnt;
+}
+
+/**
+ * Line_Reduction::__load
+ *
+ * Load start state from board
+ *
+ */
+void Line_Reduction::__load()
+{
+    int size = _board.getSize();
+    _cells.assign(size, 0);
+    _places.assign(size, 0);
+    for ( int pos = 0; pos < size; pos++ )
+    {
+        _cells[pos] = _board.getCell(pos);
+        _places[_cells[pos]] = pos;
+    }
+    _blank = _board.getBlank();
+}
+
+/**
+ * Line_Reduction::__reduce
+ *
+ * Unsolved part is a rectangle from top, left to the bottom right corner (where empty cell is in a goal),
+ * a row is placed while unsolved part is higher than wide, otherwise a column
+ * At least 3 rows (columns) are left when a row (column) is placed, so there is room to move it's last tiles
+ *
+ */
+bool Line_Reduction::__reduce()
+{
+    int width = _board.getWidth();
+    int height = _board.getHeight();
+    int top = 0;
+    int left = 0;
+    while ( height - top > 2 || width - left > 2 )
+    {
+        int rows = height - top;
+        int cols = width - left;
+        std::vector<int> line;
+        bool placed;
+        if ( rows > 2 && ( rows >= cols || cols == 2 ) )
+        {
+            for ( int x = left; x < width; x++ )
+            {
+                line.push_back(top * width + x);
+            }
+            placed = __placeLine(line, width);
+            top++;
+        }
+        else
+        {
+            for ( int y = top; y < height; y++ )
+            {
+                line.push_back(y * width + left);
+            }
+            placed = __placeLine(line, 1);
+            left++;
+        }
+        if ( ! placed )
+        {
+            return false;
+        }
+    }
+    return __rotateCorner();
+}
+
+/**
+ * Line_Reduction::__placeLine
+ *
+ * All tiles except the last two are moved straight into their places
+ * The last tile is moved into place of the last but one, which is moved next to it (inward the unsolved part),
+ * then both of them are moved into their places with two moves of empty cell
+ * If the last but one tile can't be moved next to it, both tiles are placed by Line_Reduction::__placePair
+ * line = flat positions of row or column, inward = step from line into unsolved part
+ *
+ */
+bool Line_Reduction::__placeLine(const std::vector<int> &line, int inward)
+{
+    int cnt = line.size();
+    for ( int i = 0; i < cnt - 2; i++ )
+    {
+        if ( ! __moveTile(_goalValue[line[i]], line[i]) )
+        {
+            return false;
+        }
+        _locked[line[i]] = 1;
+    }
+
+    int first = line[cnt - 2];
+    int last = line[cnt - 1];
+    if ( _places[_goalValue[first]] != first || _places[_goalValue[last]] != last )
+    {
+        if ( ! __moveTile(_goalValue[last], first) )
+        {
+            return false;
+        }
+        _locked[first] = 1;
+        if ( __moveTile(_goalValue[first], first + inward) )
+        {
+            _locked[first + inward] = 1;
+            if ( ! __moveBlank(last, -1) )
+            {
+                return false;
+            }
+            __shift(first);
+            __shift(first + inward);
+            _locked[first + inward] = 0;
+        }
+        else
+        {
+
+            // empty cell is closed in the last cell by the last but one tile, so both tiles are near the end
+            _locked[first] = 0;
+            if ( ! __placePair(first, last, inward) )
+            {
+                return false;
+            }
+        }
+    }
+    _locked[first] = 1;
+    _locked[last] = 1;
+    return true;
+}
+
+/**
+ * Line_Reduction::__placePair
+ *
+ * Place the last two tiles of line by breadth-first search over their positions and position of empty cell
+ * inside 3x2 window at the end of line (other tiles of window may be mixed)
+ * Return false if any of them is out of window
+ *
+ */
+bool Line_Reduction::__placePair(int first, int last, int inward)
+{
+    int cells[LINE_PAIR_CELLS] = {first, last, first + inward, last + inward, first + 2 * inward, last + 2 * inward};
+    int index[3] = {-1, -1, -1};
+    int values[3] = {_goalValue[first], _goalValue[last], 0};
+    for ( int i = 0; i < LINE_PAIR_CELLS; i++ )
+    {
+        for ( int k = 0; k < 3; k++ )
+        {
+            if ( _places[values[k]] == cells[i] )
+            {
+                index[k] = i;
+            }
+        }
+    }
+    if ( index[0] < 0 || index[1] < 0 || index[2] < 0 )
+    {
+        return false;
+    }
+
+    // state = (position of first tile, position of last tile, position of empty cell) in window
+    const int statesCnt = LINE_PAIR_CELLS * LINE_PAIR_CELLS * LINE_PAIR_CELLS;
+    int from[statesCnt];
+    int queue[statesCnt];
+    for ( int i = 0; i < statesCnt; i++ )
+    {
+        from[i] = -1;
+    }
+    int start = (index[0] * LINE_PAIR_CELLS + index[1]) * LINE_PAIR_CELLS + index[2];
+    int head = 0;
+    int tail = 0;
+    from[start] = start;
+    queue[tail++] = start;
+    int goal = -1;
+    while ( head < tail )
+    {
+        int state = queue[head++];
+        int a = state / (LINE_PAIR_CELLS * LINE_PAIR_CELLS);
+        int b = state / LINE_PAIR_CELLS % LINE_PAIR_CELLS;
+        int z = state % LINE_PAIR_CELLS;
+        if ( a == 0 && b == 1 )
+        {
+            goal = state;
+            break;
+        }
+        for ( int n = 0; n < LINE_PAIR_CELLS; n++ )
+        {
+            if ( __distance(cells[z], cells[n]) != 1 )
+            {
+                continue;
+            }
+            int next = ((a == n ? z : a) * LINE_PAIR_CELLS + (b == n ? z : b)) * LINE_PAIR_CELLS + n;
+            if ( from[next] < 0 )
+            {
+                from[next] = state;
+                queue[tail++] = next;
+            }
+        }
+    }
+    if ( goal < 0 )
+    {
+        return false;
+    }
+
+    // positions of empty cell from goal back to start
+    std::vector<int> route;
+    for ( int state = goal; state != start; state = from[state] )
+    {
+        route.push_back(cells[state % LINE_PAIR_CELLS]);
+    }
+    for ( int i = route.size() - 1; i >= 0; i-- )
+    {
+        __shift(route[i]);
+    }
+    return true;
+}
+
+/**
+ * Line_Reduction::__rotateCorner
+ *
+ * Empty cell goes round 2x2 corner, so three tiles of it take one of three cyclic orders
+ * Return false if none of them is a goal (odd permutation can't be solved)
+ *
+ */
+bool Line_Reduction::__rotateCorner()
+{
+    int width = _board.getWidth();
+    int corner = _board.getSize() - 1;
+    int cycle[4] = {corner - width, corner - width - 1, corner - 1, corner};
+    if ( ! __moveBlank(corner, -1) )
+    {
+        return false;
+    }
+    for ( int k = 0; k < 3; k++ )
+    {
+        bool solved = true;
+        for ( int i = 0; i < 4; i++ )
+        {
+            solved = solved && _cells[cycle[i]] == _goalValue[cycle[i]];
+        }
+        if ( solved )
+        {
+            return true;
+        }
+        for ( int i = 0; i < 4; i++ )
+        {
+            __shift(cycle[i]);
+        }
+    }
+    return false;
+}
+
+/**
+ * Line_Reduction::__moveTile
+ *
+ * Tile is moved along the shortest route over free cells, for each step of route
+ * empty cell goes round the tile to the next cell of route (macro-move), then swaps with the tile
+ *
+ */
+bool Line_Reduction::__moveTile(int value, int target)
+{
+    if ( _places[value] == target )
+    {
+        return true;
+    }
+    if ( ! __findRoute(_places[value], target, -1) )
+    {
+        return false;
+    }
+    std::vector<int> route(_route);
+    for ( unsigned int i = 0; i < route.size(); i++ )
+    {
+        if ( ! __moveBlank(route[i], _places[value]) )
+        {
+            return false;
+        }
+        __shift(_places[value]);
+    }
+    return true;
+}
+
+/**
+ * Line_Reduction::__moveBlank
+ *
+ * Move empty cell along the shortest route over free cells, cell avoid (moved tile) isn't touched
+ *
+ */
+bool Line_Reduction::__moveBlank(int target, int avoid)
+{
+    if ( _blank == target )
+    {
+        return true;
+    }
+    if ( ! __findRoute(_blank, target, avoid) )
+    {
+        return false;
+    }
+    for ( unsigned int i = 0; i < _route.size(); i++ )
+    {
+        __shift(_route[i]);
+    }
+    return true;
+}
+
+/**
+ * Line_Reduction::__findRoute
+ *
+ * Breadth-first search from one cell to another over cells which aren't locked
+ * Search stops as soon as target is reached, so short routes are found in a few steps on any board
+ * Route is saved in _route (without start cell)
+ *
+ */
+bool Line_Reduction::__findRoute(int from, int to, int avoid)
+{
+    if ( ! ++_stampId )
+    {
+
+        // ids are exhausted, start again
+        std::fill(_stamp.begin(), _stamp.end(), 0);
+        _stampId = 1;
+    }
+    int head = 0;
+    int tail = 0;
+    _stamp[from] = _stampId;
+    _queue[tail++] = from;
+    while ( head < tail && _stamp[to] != _stampId )
+    {
+        int pos = _queue[head++];
+        const int *moves = &_moveTable->moves[pos * NEIGHBOURS_CNT_MAX];
+        for ( int i = 0; i < _moveTable->movesCnt[pos]; i++ )
+        {
+            int nbr = moves[i];
+            if ( _stamp[nbr] == _stampId || _locked[nbr] || nbr == avoid )
+            {
+                continue;
+            }
+            _stamp[nbr] = _stampId;
+            _from[nbr] = pos;
+            _queue[tail++] = nbr;
+        }
+    }
+    if ( _stamp[to] != _stampId )
+    {
+        return false;
+    }
+    _route.clear();
+    for ( int pos = to; pos != from; pos = _from[pos] )
+    {
+        _route.push_back(pos);
+    }
+    std::reverse(_route.begin(), _route.end());
+    return true;
+}
+
+/**
+ * Line_Reduction::__swap
+ *
+ */
+inline void Line_Reduction::__swap(int pos)
+{
+    int value = _cells[pos];
+    _cells[_blank] = value;
+    _places[value] = _blank;
+    _cells[pos] = 0;
+    _places[0] = pos;
+    _blank = pos;
+}
+
+/**
+ * Line_Reduction::__shift
+ *
+ */
+inline void Line_Reduction::__shift(int pos)
+{
+    _moves.push_back(_cells[pos]);
+    __swap(pos);
+    _madeStepsCnt++;
+}
+
+/**
+ * Line_Reduction::__distance
+ *
+ */
+inline int Line_Reduction::__distance(int pos, int target)
+{
+    int width = _board.getWidth();
+    return abs(pos / width - target / width) + abs(pos % width - target % width);
+}
+
+/**
+ * Line_Reduction::__shorten
+ *
+ * Window slides over solution, it's start state is current state and end state is kept as tiles positions
+ * Only tiles moved inside window differ, so sum of their distances to end positions is an admissible bound
+ * Window is replaced if a path shorter by 2 moves or more is found (lengths of all paths have the same parity)
+ *
+ */
+void Line_Reduction::__shorten()
+{
+    __load();
+    _targetPlaces = _places;
+    int window = _window;
+    for ( int i = 0; i < window && i < (int)_moves.size(); i++ )
+    {
+        std::swap(_targetPlaces[0], _targetPlaces[_moves[i]]);
+    }
+
+    for ( int i = 0; i + window <= (int)_moves.size(); i++ )
+    {
+
+        // distances of tiles moved inside window
+        int h = 0;
+        if ( ! ++_stampId )
+        {
+            std::fill(_stamp.begin(), _stamp.end(), 0);
+            _stampId = 1;
+        }
+        for ( int k = i; k < i + window; k++ )
+        {
+            int value = _moves[k];
+            if ( _stamp[value] != _stampId )
+            {
+                _stamp[value] = _stampId;
+                h += __distance(_places[value], _targetPlaces[value]);
+            }
+        }
+
+        _nodes = 0;
+        for ( int limit = h + ((window - h) & 1); limit <= window - 2; limit += 2 )
+        {
+            _segment.clear();
+            if ( __searchWindow(0, limit, h, -1) )
+            {
+                _moves.erase(_moves.begin() + i, _moves.begin() + i + window);
+                _moves.insert(_moves.begin() + i, _segment.begin(), _segment.end());
+
+                // end state is reached earlier, move it to the end of window again
+                for ( int k = i + _segment.size(); k < i + window && k < (int)_moves.size(); k++ )
+                {
+                    std::swap(_targetPlaces[0], _targetPlaces[_moves[k]]);
+                }
+                break;
+            }
+            if ( _nodes > LINE_WINDOW_NODES_MAX )
+            {
+                break;
+            }
+        }
+
+        if ( i < (int)_moves.size() )
+        {
+            __swap(_places[_moves[i]]);
+        }
+        if ( i + window < (int)_moves.size() )
+        {
+            std::swap(_targetPlaces[0], _targetPlaces[_moves[i + window]]);
+        }
+    }
+}
+
+/**
+ * Line_Reduction::__searchWindow
+ *
+ * Depth-first search from current state to end state of window with cost limit
+ * h = sum of tiles distances to their end positions
+ * prev = flat position of empty cell before previous step (-1 at the start)
+ * State is restored on return, found path is left in _segment
+ *
+ */
+bool Line_Reduction::__searchWindow(int depth, int limit, int h, int prev)
+{
+    if ( ! h )
+    {
+
+        // all tiles are in their end positions, so empty cell is there too
+        return true;
+    }
+    if ( depth + h > limit || _nodes > LINE_WINDOW_NODES_MAX )
+    {
+        return false;
+    }
+    int blank = _blank;
+    const int *moves = &_moveTable->moves[blank * NEIGHBOURS_CNT_MAX];
+    for ( int i = 0; i < _moveTable->movesCnt[blank]; i++ )
+    {
+        int pos = moves[i];
+        if ( pos == prev )
+        {
+            continue;
+        }
+        int value = _cells[pos];
+        int delta = __distance(blank, _targetPlaces[value]) - __distance(pos, _targetPlaces[value]);
+        __swap(pos);
+        _segment.push_back(value);
+        _nodes++;
+        _madeStepsCnt++;
+        bool found = __searchWindow(depth + 1, limit, h + delta, blank);
+        __swap(blank);
+        if ( found )
+        {
+            return true;
+        }
+        _segment.pop_back();
+    }
+    return false;
+}
+
+/**
+ * Line_Reduction destructor
+ *
+ */
+Line_Reduction::~Line_Reduction()
+{
+}
@@ -27,6 +27,7 @@
 #include <time.h>
 
 Logger* Logger::_loggerInstance = 0; // declare static pointer to Logger instance
+thread_local Logger* Logger::_threadLoggerInstance = 0; // instance of calling thread (overrides common one)
 
 /**
  * Logger::getInstance
@@ -37,6 +38,10 @@ Logger* Logger::_loggerInstance = 0; // declare static pointer to Logger instanc
  */
 Logger& Logger::getInstance()
 {
+    if ( _threadLoggerInstance )
+    {
+        return *_threadLoggerInstance;
+    }
     if ( ! _loggerInstance )
     {
         _loggerInstance = new ConsoleLogger();
@@ -44,20 +49,50 @@ Logger& Logger::getInstance()
     return *_loggerInstance;
 }
 
+/**
+ * Logger::setInstance
+ *
+ * Replace concrete logger instance, ex. with NullLogger to keep STDOUT clean
+ * Should be called before any threads are started
+ *
+ */
+void Logger::setInstance(Logger *logger)
+{
+    _loggerInstance = logger;
+}
+
+/**
+ * Logger::setThreadInstance
+ *
+ * Replace logger instance only for calling thread, ex. library call keeps console of application clean
+ * while other threads log as usual (NULL - use common instance)
+ *
+ * Return previous instance of thread
+ *
+ */
+Logger* Logger::setThreadInstance(Logger *logger)
+{
+    Logger *previous = _threadLoggerInstance;
+    _threadLoggerInstance = logger;
+    return previous;
+}
+
 /**
  * Logger::timestamp
  *
  * Common method for writing timestamp
  * Timestamp is followed by a new-line character ('\n')
+ * Reentrant, so solvers in different threads may write it at the same time
  *
  */
 void Logger::timestamp()
 {
     time_t rawtime;
-    struct tm * timeinfo;
+    struct tm timeinfo;
+    char buf[32];
     time(&rawtime);
-    timeinfo = localtime(&rawtime);
-    this->write(asctime(timeinfo));
+    localtime_r(&rawtime, &timeinfo);
+    this->write(asctime_r(&timeinfo, buf));
 }
 
 /**
@@ -0,0 +1,316 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "MoveAutomaton.h"
+#include <algorithm>
+#include <unordered_map>
+
+/**
+ * MoveAutomaton constructor
+ *
+ * Automaton without pruned sequences, use MoveAutomaton::get
+ *
+ */
+MoveAutomaton::MoveAutomaton()
+{
+    _next.assign(4, 0);
+    _sequencesCnt = 0;
+}
+
+/**
+ * MoveAutomaton::get
+ *
+ * Get automaton of sequences up to depth moves for board geometry (0 - default depth, see getDefaultDepth)
+ * Automaton is built on first request and shared by all solvers with the same dimension and depth
+ *
+ */
+const MoveAutomaton* MoveAutomaton::get(int width, int height, int depth)
+{
+    static std::map<std::vector<int>, MoveAutomaton> automata;
+    static boost::mutex automataMutex;
+
+    if ( depth <= 0 )
+    {
+        depth = getDefaultDepth(width, height);
+    }
+    depth = std::min(depth, MOVE_AUTOMATON_DEPTH);
+
+    // critical section
+    boost::mutex::scoped_lock lock(automataMutex);
+    std::vector<int> key;
+    key.push_back(width);
+    key.push_back(height);
+    key.push_back(depth);
+    std::map<std::vector<int>, MoveAutomaton>::iterator it = automata.find(key);
+    if ( it != automata.end() )
+    {
+        return &it->second;
+    }
+
+    MoveAutomaton &automaton = automata[key];
+    automaton.__build(width, height, depth);
+    return &automaton;
+}
+
+/**
+ * MoveAutomaton::getDefaultDepth
+ *
+ * Build time grows ~3x with each move of depth (12 moves take 0.6 sec on 4x4 and 3 sec on 10x10),
+ * while each move beyond 8 saves only a few percent of nodes, so longer sequences pay off
+ * only for 4x4-like boards, where solutions take seconds
+ *
+ */
+int MoveAutomaton::getDefaultDepth(int width, int height)
+{
+    int size = width * height;
+    if ( size > 9 && size <= 16 )
+    {
+        return MOVE_AUTOMATON_DEPTH_4x4;
+    }
+    return MOVE_AUTOMATON_DEPTH_DEFAULT;
+}
+
+/**
+ * MoveAutomaton::getStatesCnt
+ *
+ */
+int MoveAutomaton::getStatesCnt() const
+{
+    return _next.size() / 4;
+}
+
+/**
+ * MoveAutomaton::getSequencesCnt
+ *
+ */
+int MoveAutomaton::getSequencesCnt() const
+{
+    return _sequencesCnt;
+}
+
+/**
+ * MoveAutomaton::__effect
+ *
+ * Sequence is applied to an unbounded board, where empty cell starts at (0, 0)
+ * Effect is final position of empty cell and new position of each moved tile,
+ * sequences with the same effect lead to the same state from any state
+ * bounds = [min x, max x, min y, max y] of cells visited by empty cell
+ *
+ */
+std::string MoveAutomaton::__effect(const std::string &moves, int *bounds)
+{
+    static const int dx[4] = {-1, 0, 1, 0};
+    static const int dy[4] = {0, -1, 0, 1};
+    const int side = 2 * MOVE_AUTOMATON_DEPTH + 1;
+
+    // touched cell => tile, which is there now (-1 is empty cell)
+    std::vector<std::pair<int, int> > touched;
+    int x = 0;
+    int y = 0;
+    bounds[0] = bounds[1] = bounds[2] = bounds[3] = 0;
+    touched.push_back(std::make_pair(MOVE_AUTOMATON_DEPTH * side + MOVE_AUTOMATON_DEPTH, -1));
+    for ( size_t i = 0; i < moves.size(); i++ )
+    {
+        int blank = (y + MOVE_AUTOMATON_DEPTH) * side + x + MOVE_AUTOMATON_DEPTH;
+        x += dx[(int)moves[i]];
+        y += dy[(int)moves[i]];
+        bounds[0] = std::min(bounds[0], x);
+        bounds[1] = std::max(bounds[1], x);
+        bounds[2] = std::min(bounds[2], y);
+        bounds[3] = std::max(bounds[3], y);
+        int cell = (y + MOVE_AUTOMATON_DEPTH) * side + x + MOVE_AUTOMATON_DEPTH;
+
+        // tile of neighbour cell is moved into empty cell
+        int tile = cell;
+        size_t k = 0;
+        while ( k < touched.size() && touched[k].first != cell )
+        {
+            k++;
+        }
+        if ( k < touched.size() )
+        {
+            tile = touched[k].second;
+            touched[k].second = -1;
+        }
+        else
+        {
+            touched.push_back(std::make_pair(cell, -1));
+        }
+        for ( k = 0; touched[k].first != blank; k++ );
+        touched[k].second = tile;
+    }
+
+    std::sort(touched.begin(), touched.end());
+    std::string effect;
+    effect += (char)x;
+    effect += (char)y;
+    for ( size_t k = 0; k < touched.size(); k++ )
+    {
+        if ( touched[k].second >= 0 && touched[k].second != touched[k].first )
+        {
+            effect += (char)(touched[k].first / side);
+            effect += (char)(touched[k].first % side);
+            effect += (char)(touched[k].second / side);
+            effect += (char)(touched[k].second % side);
+        }
+    }
+    return effect;
+}
+
+/**
+ * MoveAutomaton::__build
+ *
+ * Sequences up to depth moves (at most MOVE_AUTOMATON_DEPTH) are generated by length and lexicographically,
+ * so the first sequence with some effect is the preferred one, others are duplicates
+ * Sequences, which don't fit into board, or are duplicates, aren't extended
+ * Duplicates are matched by Aho-Corasick automaton, states where any duplicate ends are removed
+ *
+ */
+void MoveAutomaton::__build(int width, int height, int depth)
+{
+    std::unordered_map<std::string, std::vector<int> > effects;  // effect => bounds of preferred sequence
+    std::vector<std::string> level(1, "");
+    std::vector<std::string> nextLevel;
+    std::vector<std::string> sequences;
+    int bounds[4];
+    effects[__effect("", bounds)].assign(bounds, bounds + 4);
+
+    for ( int length = 1; length <= depth; length++ )
+    {
+        for ( size_t i = 0; i < level.size(); i++ )
+        {
+            for ( int direction = 0; direction < 4; direction++ )
+            {
+                std::string moves = level[i] + (char)direction;
+                std::string effect = __effect(moves, bounds);
+                if ( bounds[1] - bounds[0] >= width || bounds[3] - bounds[2] >= height )
+                {
+
+                    // impossible on this board
+                    continue;
+                }
+                std::unordered_map<std::string, std::vector<int> >::iterator it = effects.find(effect);
+                if ( it == effects.end() )
+                {
+                    effects[effect].assign(bounds, bounds + 4);
+                    nextLevel.push_back(moves);
+                    continue;
+                }
+                const std::vector<int> &preferred = it->second;
+                if ( preferred[0] >= bounds[0] && preferred[1] <= bounds[1]
+                     && preferred[2] >= bounds[2] && preferred[3] <= bounds[3] )
+                {
+                    sequences.push_back(moves);
+                }
+                else
+                {
+
+                    // preferred sequence may be impossible where this one is possible
+                    nextLevel.push_back(moves);
+                }
+            }
+        }
+        level.swap(nextLevel);
+        nextLevel.clear();
+    }
+
+    // trie of duplicate sequences
+    std::vector<int> go(4, -1);
+    std::vector<char> pruned(1, 0);
+    for ( size_t i = 0; i < sequences.size(); i++ )
+    {
+        int node = 0;
+        for ( size_t k = 0; k < sequences[i].size(); k++ )
+        {
+            int direction = sequences[i][k];
+            if ( go[node * 4 + direction] < 0 )
+            {
+                go[node * 4 + direction] = pruned.size();
+                pruned.push_back(0);
+                go.insert(go.end(), 4, -1);
+            }
+            node = go[node * 4 + direction];
+        }
+        pruned[node] = 1;
+    }
+
+    // failure links (breadth-first), missing transitions are taken from failure state
+    int nodesCnt = pruned.size();
+    std::vector<int> fail(nodesCnt, 0);
+    std::vector<int> queue;
+    queue.reserve(nodesCnt);
+    for ( int direction = 0; direction < 4; direction++ )
+    {
+        if ( go[direction] < 0 )
+        {
+            go[direction] = 0;
+        }
+        else
+        {
+            queue.push_back(go[direction]);
+        }
+    }
+    for ( size_t head = 0; head < queue.size(); head++ )
+    {
+        int node = queue[head];
+        pruned[node] |= pruned[fail[node]];
+        for ( int direction = 0; direction < 4; direction++ )
+        {
+            int child = go[node * 4 + direction];
+            int failNext = go[fail[node] * 4 + direction];
+            if ( child < 0 )
+            {
+                go[node * 4 + direction] = failNext;
+            }
+            else
+            {
+                fail[child] = failNext;
+                queue.push_back(child);
+            }
+        }
+    }
+
+    // renumber states without duplicates
+    std::vector<int> state(nodesCnt, MOVE_AUTOMATON_PRUNED);
+    int statesCnt = 0;
+    for ( int node = 0; node < nodesCnt; node++ )
+    {
+        if ( ! pruned[node] )
+        {
+            state[node] = statesCnt++;
+        }
+    }
+    _next.assign(statesCnt * 4, MOVE_AUTOMATON_PRUNED);
+    for ( int node = 0; node < nodesCnt; node++ )
+    {
+        if ( ! pruned[node] )
+        {
+            for ( int direction = 0; direction < 4; direction++ )
+            {
+                _next[state[node] * 4 + direction] = state[go[node * 4 + direction]];
+            }
+        }
+    }
+    _sequencesCnt = sequences.size();
+}
@@ -0,0 +1,388 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "PatternDB.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * PatternDB constructor
+ *
+ * Split tiles into groups by partition like "6-6-3"
+ * Tables are empty until build or load is called
+ *
+ */
+PatternDB::PatternDB(int width, int height, const std::string partition)
+{
+    _width = width;
+    _height = height;
+    _size = width * height;
+
+    std::vector<int> sizes;
+    int tiles = _size - 1;
+    if ( partition.length() )
+    {
+        const char *p = partition.c_str();
+        while ( *p )
+        {
+            char *end = NULL;
+            long n = strtol(p, &end, 10);
+            if ( end == p || n <= 0 || ( *end && *end != '-' ) )
+            {
+                Logger::getInstance().errorAt("PatternDB::PatternDB")
+                .explain("bad partition '").append(partition).append("'").endl();
+                return;
+            }
+            sizes.push_back(n);
+            p = *end ? end + 1 : end;
+        }
+    }
+    else
+    {
+        for ( int left = tiles; left > 0; left -= PDB_GROUP_SIZE_DEFAULT )
+            sizes.push_back(left < PDB_GROUP_SIZE_DEFAULT ? left : PDB_GROUP_SIZE_DEFAULT);
+    }
+
+    int sum = 0;
+    for ( unsigned int i = 0; i < sizes.size(); i++ )
+        sum += sizes[i];
+    if ( sum != tiles || _size > 64 )
+    {
+        Logger::getInstance().errorAt("PatternDB::PatternDB")
+        .explain("partition '").append(partition)
+        .append("' doesn't cover ").append(tiles)
+        .append(" tiles of board (or board has more than 64 cells)").endl();
+        return;
+    }
+
+    _groupOf.assign(_size, -1);
+    int value = 1;
+    for ( unsigned int i = 0; i < sizes.size(); i++ )
+    {
+        Group group;
+        for ( int t = 0; t < sizes[i]; t++ )
+        {
+            _groupOf[value] = i;
+            group.tiles.push_back(value++);
+        }
+
+        // multiplier of i-th tile is count of arrangements of next tiles
+        int k = sizes[i];
+        group.multipliers.assign(k, 1);
+        for ( int t = k - 2; t >= 0; t-- )
+            group.multipliers[t] = group.multipliers[t + 1] * (_size - 1 - t);
+        _groups.push_back(group);
+    }
+}
+
+/**
+ * PatternDB::isNotNull
+ *
+ * Check if partition was valid
+ *
+ */
+bool PatternDB::isNotNull()
+{
+    return _groups.size() ? true : false;
+}
+
+/**
+ * PatternDB::getWidth
+ *
+ */
+int PatternDB::getWidth()
+{
+    return _width;
+}
+
+/**
+ * PatternDB::getHeight
+ *
+ */
+int PatternDB::getHeight()
+{
+    return _height;
+}
+
+/**
+ * PatternDB::getGroupsCnt
+ *
+ */
+int PatternDB::getGroupsCnt()
+{
+    return _groups.size();
+}
+
+/**
+ * PatternDB::build
+ *
+ * Build tables of all groups for goal (value => flat position)
+ *
+ */
+bool PatternDB::build(const int * const goal)
+{
+    if ( ! isNotNull() )
+    {
+        return false;
+    }
+    _goal.assign(goal, goal + _size);
+    const MoveTable *moveTable = Board::getMoveTable(_width, _height);
+    for ( unsigned int i = 0; i < _groups.size(); i++ )
+    {
+        Logger::getInstance().append("Building pattern database ")
+        .append(i + 1).append("/").append(_groups.size()).append(" ... ");
+        if ( ! __buildGroup(_groups[i], moveTable) )
+        {
+            return false;
+        }
+        Logger::getInstance().append("done").endl();
+    }
+    return true;
+}
+
+/**
+ * PatternDB::load
+ *
+ * Load tables from file, which was saved for the same dimension, partition and goal
+ *
+ */
+bool PatternDB::load(const std::string path, const int * const goal)
+{
+    if ( ! isNotNull() || ! path.length() )
+    {
+        return false;
+    }
+    FILE *f = fopen(path.c_str(), "rb");
+    if ( ! f )
+    {
+        return false;
+    }
+    bool ok = true;
+    char magic[sizeof(PDB_FILE_MAGIC)];
+    int header[3];
+    ok = ok && fread(magic, 1, sizeof(magic), f) == sizeof(magic)
+         && ! memcmp(magic, PDB_FILE_MAGIC, sizeof(magic));
+    ok = ok && fread(header, sizeof(int), 3, f) == 3
+         && header[0] == _width && header[1] == _height && header[2] == (int)_groups.size();
+    std::vector<int> fileGoal(_size);
+    ok = ok && fread(&fileGoal[0], sizeof(int), _size, f) == (size_t)_size
+         && ! memcmp(&fileGoal[0], goal, _size * sizeof(int));
+    for ( unsigned int i = 0; ok && i < _groups.size(); i++ )
+    {
+        Group &g = _groups[i];
+        int k = 0;
+        ok = fread(&k, sizeof(int), 1, f) == 1 && k == (int)g.tiles.size();
+        std::vector<int> tiles(k > 0 ? k : 0);
+        ok = ok && fread(&tiles[0], sizeof(int), k, f) == (size_t)k && tiles == g.tiles;
+        uint64_t cnt = ok ? g.multipliers[0] * _size : 0;
+        g.costs.resize(cnt);
+        ok = ok && fread(&g.costs[0], 1, cnt, f) == cnt;
+    }
+    fclose(f);
+    if ( ok )
+    {
+        _goal.assign(goal, goal + _size);
+    }
+    else
+    {
+        for ( unsigned int i = 0; i < _groups.size(); i++ )
+            std::vector<unsigned char>().swap(_groups[i].costs);
+    }
+    return ok;
+}
+
+/**
+ * PatternDB::save
+ *
+ * Save tables into file (see PatternDB::load)
+ *
+ */
+bool PatternDB::save(const std::string path)
+{
+    if ( ! isNotNull() || ! path.length() || _groups[0].costs.empty() )
+    {
+        return false;
+    }
+    FILE *f = fopen(path.c_str(), "wb");
+    if ( ! f )
+    {
+        Logger::getInstance().errorAt("PatternDB::save")
+        .explain("can't open '").append(path).append("' for writing").endl();
+        return false;
+    }
+    int header[3] = { _width, _height, (int)_groups.size() };
+    bool ok = fwrite(PDB_FILE_MAGIC, 1, sizeof(PDB_FILE_MAGIC), f) == sizeof(PDB_FILE_MAGIC);
+    ok = ok && fwrite(header, sizeof(int), 3, f) == 3;
+    ok = ok && fwrite(&_goal[0], sizeof(int), _size, f) == (size_t)_size;
+    for ( unsigned int i = 0; ok && i < _groups.size(); i++ )
+    {
+        Group &g = _groups[i];
+        int k = g.tiles.size();
+        ok = fwrite(&k, sizeof(int), 1, f) == 1;
+        ok = ok && fwrite(&g.tiles[0], sizeof(int), k, f) == (size_t)k;
+        ok = ok && fwrite(&g.costs[0], 1, g.costs.size(), f) == g.costs.size();
+    }
+    fclose(f);
+    return ok;
+}
+
+/**
+ * PatternDB::__unrank
+ *
+ * Positions of group tiles by rank (see PatternDB::__rank)
+ *
+ */
+void PatternDB::__unrank(const Group &group, uint64_t rank, int * const positions)
+{
+    uint64_t taken = 0;
+    for ( unsigned int i = 0; i < group.tiles.size(); i++ )
+    {
+        int digit = rank / group.multipliers[i];
+        rank %= group.multipliers[i];
+
+        // digit-th position which isn't taken
+        int pos = 0;
+        for ( ;; pos++ )
+        {
+            if ( taken & (1ULL << pos) )
+                continue;
+            if ( ! digit-- )
+                break;
+        }
+        taken |= 1ULL << pos;
+        positions[i] = pos;
+    }
+}
+
+/**
+ * PatternDB::__buildGroup
+ *
+ * Backward breadth-first search from a goal state
+ * State is (positions of group tiles, position of empty cell),
+ * moves of other tiles are free, so all cells reachable by empty cell
+ * without moving group tiles are visited at once (flood fill)
+ * and only moves of group tiles increase cost
+ *
+ * Table keeps minimal cost over all positions of empty cell
+ *
+ */
+bool PatternDB::__buildGroup(Group &group, const MoveTable *moveTable)
+{
+    int k = group.tiles.size();
+    uint64_t configs = group.multipliers[0] * _size;
+    uint64_t states = configs * _size;
+    if ( states > PDB_STATES_MAX )
+    {
+        Logger::getInstance().endl().errorAt("PatternDB::__buildGroup")
+        .explain("group of ").append(k)
+        .append(" tiles is too big for ").append(_width).append("x").append(_height)
+        .append(" board").endl();
+        return false;
+    }
+    group.costs.assign(configs, PDB_COST_UNKNOWN);
+
+    // bitsets of states
+    uint64_t words = (states + 63) / 64;
+    std::vector<uint64_t> visited(words, 0);
+    std::vector<uint64_t> frontier(words, 0);
+    std::vector<uint64_t> next(words, 0);
+
+    int positions[BOARD_CELLS_MAX];
+    int owner[BOARD_CELLS_MAX];               // flat position => group tile index (-1 if free)
+    int region[BOARD_CELLS_MAX];
+    for ( int i = 0; i < k; i++ )
+        positions[i] = _goal[group.tiles[i]];
+    uint64_t start = __rank(group, positions);
+    group.costs[start] = 0;
+    uint64_t s = start * _size + _goal[0];
+    frontier[s >> 6] |= 1ULL << (s & 63);
+
+    bool found = true;
+    for ( int cost = 0; found; cost++ )
+    {
+        found = false;
+        for ( uint64_t w = 0; w < words; w++ )
+        {
+            while ( frontier[w] )
+            {
+                int bit = __builtin_ctzll(frontier[w]);
+                frontier[w] &= frontier[w] - 1;
+                uint64_t state = (w << 6) + bit;
+                if ( visited[w] & (1ULL << bit) )
+                {
+                    continue;
+                }
+                uint64_t rank = state / _size;
+                __unrank(group, rank, positions);
+                for ( int pos = 0; pos < _size; pos++ )
+                    owner[pos] = -1;
+                for ( int i = 0; i < k; i++ )
+                    owner[positions[i]] = i;
+
+                // flood fill cells reachable by empty cell for free
+                int regionCnt = 0;
+                region[regionCnt++] = state % _size;
+                visited[w] |= 1ULL << bit;
+                for ( int r = 0; r < regionCnt; r++ )
+                {
+                    int cell = region[r];
+                    const int *m = &moveTable->moves[cell * NEIGHBOURS_CNT_MAX];
+                    for ( int n = 0; n < moveTable->movesCnt[cell]; n++ )
+                    {
+                        int to = m[n];
+                        int tile = owner[to];
+                        if ( tile < 0 )
+                        {
+                            uint64_t fs = rank * _size + to;
+                            if ( ! ( visited[fs >> 6] & (1ULL << (fs & 63)) ) )
+                            {
+                                visited[fs >> 6] |= 1ULL << (fs & 63);
+                                region[regionCnt++] = to;
+                            }
+                            continue;
+                        }
+
+                        // group tile moves into empty cell
+                        positions[tile] = cell;
+                        uint64_t moved = __rank(group, positions);
+                        positions[tile] = to;
+                        uint64_t ns = moved * _size + to;
+                        if ( ! ( visited[ns >> 6] & (1ULL << (ns & 63)) ) )
+                        {
+                            next[ns >> 6] |= 1ULL << (ns & 63);
+                            found = true;
+                            if ( group.costs[moved] == PDB_COST_UNKNOWN )
+                            {
+                                group.costs[moved] = cost + 1;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        frontier.swap(next);
+    }
+    return true;
+}
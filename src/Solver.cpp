@@ -25,76 +25,258 @@
 #include "Solver.h"
 #include <stdio.h>
 #include <sstream>
-
-// declaration of static variables (should be seen from all threads)
-int Solver::_slnStepsCnt = std::numeric_limits<int>::max();
-int Solver::_cpu_units = 0;
-std::map<int, std::string> Solver::_slnStates;
-std::vector<int> Solver::_slnShuffles;
+#include <string.h>
 
 /**
  * Solver constructor
  *
  */
-Solver::Solver(Board &b, int cpuUnits)
+Solver::Solver(Board &b, int cpuUnits) : _board(b)
 {
-    _board = b;
+    __resetSolution();
+    _cpuUnits = cpuUnits;
+    _fixed = false;
     _madeStepsCnt = 0;
-    Solver::_cpu_units = cpuUnits;
+    _heuristic = HEURISTIC_MANHATTAN;
+    _pdb = NULL;
+    _wd = NULL;
+    _automaton = NULL;
+    _movePruning = false;
+    _movePruningDepth = 0;
+    _bsIndex = NULL;
+    _mdIndex = NULL;
+    _hIndex = NULL;
+    _tilePos = NULL;
+    _lcIndex = NULL;
+    _path = NULL;
     __init();
 }
 
 /**
  * Solver copy constructor
  *
+ * Copy gets it's own goal Index, so it may live longer than original
+ *
+ */
+Solver::Solver(const Solver &solver) : _board(solver._board)
+{
+    __resetSolution();
+    _cpuUnits = solver._cpuUnits;
+    _fixed = solver._fixed;
+    _madeStepsCnt = 0;
+    memcpy(_algName, solver._algName, sizeof(_algName));
+
+    // copy bsIndex and mdIndex
+    _bsIndex = (int (*)[2])_arena.allocate(_board.getSize() * sizeof(*_bsIndex));
+    memcpy(_bsIndex, solver._bsIndex, _board.getSize() * sizeof(*_bsIndex));
+    int size = _board.getSize();
+    _mdIndex = (unsigned short*)_arena.allocate(size * size * sizeof(*_mdIndex));
+    memcpy(_mdIndex, solver._mdIndex, size * size * sizeof(*_mdIndex));
+
+    // copy hIndex, tilePos, lcIndex and path
+    _heuristic = solver._heuristic;
+    _pdb = solver._pdb;
+    _wd = solver._wd;
+    _automaton = solver._automaton;
+    _movePruning = solver._movePruning;
+    _movePruningDepth = solver._movePruningDepth;
+    __setContext(_arena.allocate(__contextSize()));
+    memcpy(_hIndex, solver._hIndex, __contextSize());
+}
+
+/**
+ * Solver copy constructor
+ *
+ * Copy search state into context preallocated by original (see IDA_Star::__nbrSolver)
+ * Goal Index is shared, so original must outlive the copy
+ *
  */
-Solver::Solver(const Solver &solver)
+Solver::Solver(const Solver &solver, void *context) : _board(solver._board)
 {
-    *this = solver;
+    __resetSolution();
+    _cpuUnits = solver._cpuUnits;
+    _fixed = solver._fixed;
     _madeStepsCnt = 0;
+    memcpy(_algName, solver._algName, sizeof(_algName));
+    _bsIndex = solver._bsIndex;
+    _mdIndex = solver._mdIndex;
+    _heuristic = solver._heuristic;
+    _pdb = solver._pdb;
+    _wd = solver._wd;
+    _automaton = solver._automaton;
+    _movePruning = solver._movePruning;
+    _movePruningDepth = solver._movePruningDepth;
+    __setContext(context);
+    memcpy(_hIndex, solver._hIndex, __contextSize());
+}
+
+/**
+ * Solver::getGoal
+ *
+ * Fill goal with flat position of each value in a goal state (see Solver::__bsIndex)
+ *
+ */
+void Solver::getGoal(int * const goal)
+{
+    for ( int i = 0; i < _board.getSize(); i++ )
+    {
+        goal[i] = _bsIndex[i][0] * _board.getWidth() + _bsIndex[i][1];
+    }
+}
 
-    // copy board
-    Board* b = new Board(solver._board);
-    _board = *b;
+/**
+ * Solver::setHeuristic
+ *
+ * Use Manhattan distance (HEURISTIC_MANHATTAN) or Manhattan distance of tiles
+ * plus linear conflicts (HEURISTIC_LINEAR_CONFLICT) as heuristic
+ * Pattern databases are set with Solver::setPatternDB
+ *
+ */
+bool Solver::setHeuristic(int heuristic)
+{
+    if ( ! _board.isNotNull()
+         || ( heuristic != HEURISTIC_MANHATTAN && heuristic != HEURISTIC_LINEAR_CONFLICT ) )
+    {
+        Logger::getInstance().errorAt("Solver::setHeuristic")
+        .explain("unknown heuristic ").append(heuristic).endl();
+        return false;
+    }
+    _heuristic = heuristic;
+    _pdb = NULL;
+    _wd = NULL;
+    __hIndex();
+    return true;
+}
 
-    // copy bsIndex
-    _bsIndex = new int *[_board.getSize()];
-    for ( int x = 0; x < _board.getSize(); x++ )
+/**
+ * Solver::setPatternDB
+ *
+ * Use pattern databases as heuristic instead of Manhattan distance
+ * Databases should be built (or loaded) for the same board dimension and goal
+ *
+ */
+bool Solver::setPatternDB(PatternDB *pdb)
+{
+    if ( ! _board.isNotNull() || ! pdb || ! pdb->isNotNull()
+         || pdb->getWidth() != _board.getWidth() || pdb->getHeight() != _board.getHeight() )
     {
-        _bsIndex[x] = new int[2];
-        _bsIndex[x][0] = solver._bsIndex[x][0];
-        _bsIndex[x][1] = solver._bsIndex[x][1];
+        Logger::getInstance().errorAt("Solver::setPatternDB")
+        .explain("pattern databases don't match board").endl();
+        return false;
     }
+    _heuristic = HEURISTIC_PDB;
+    _pdb = pdb;
+    _wd = NULL;
+    __hIndex();
+    return true;
+}
 
-    // copy hIndex
-    _hIndex = new int[_board.getSize() + 1];
-    for ( int x = 0; x <= _board.getSize(); x++ )
-        _hIndex[x] = solver._hIndex[x];
+/**
+ * Solver::setWalkingDistance
+ *
+ * Use walking distance as heuristic instead of Manhattan distance
+ * Tables should be built for the same board dimension and goal
+ *
+ */
+bool Solver::setWalkingDistance(WalkingDistance *wd)
+{
+    if ( ! _board.isNotNull() || ! wd || ! wd->isNotNull()
+         || wd->getWidth() != _board.getWidth() || wd->getHeight() != _board.getHeight() )
+    {
+        Logger::getInstance().errorAt("Solver::setWalkingDistance")
+        .explain("walking distance tables don't match board").endl();
+        return false;
+    }
+    _heuristic = HEURISTIC_WALKING_DISTANCE;
+    _wd = wd;
+    _pdb = NULL;
+    __hIndex();
+    return true;
+}
+
+/**
+ * Solver::setMovePruning
+ *
+ * Skip moves, which complete a duplicate sequence of moves (see MoveAutomaton)
+ * Automaton is built for board dimension and depth on first use (0 - depth which pays off for dimension)
+ * by solve, so it's counted in solution time (and time limit of IDA*)
+ *
+ */
+void Solver::setMovePruning(bool enabled, int depth)
+{
+    _automaton = NULL;
+    _movePruning = enabled && _board.isNotNull();
+    _movePruningDepth = depth;
+}
+
+/**
+ * Solver::getStepsCount
+ *
+ * Count of steps in solution found by the last solve call
+ * Max int if solution wasn't found (ex. time is over)
+ *
+ */
+int Solver::getStepsCount()
+{
+    return _sln.stepsCnt;
+}
+
+/**
+ * Solver::getShuffles
+ *
+ * Solution shuffles (empty cell neighbours to shuffle with) found by the last solve call
+ *
+ */
+const std::vector<int>& Solver::getShuffles()
+{
+    return _sln.shuffles;
+}
+
+/**
+ * Solver::getMadeStepsCount
+ *
+ * Count of steps made by the last solve call (made by all workers of multi-threaded version)
+ *
+ */
+double Solver::getMadeStepsCount()
+{
+    return _madeStepsCnt;
+}
+
+/**
+ * Solver::isFixed
+ *
+ * Unsolvable board is fixed by swap of two last tiles in constructor,
+ * so solution is found for the fixed board
+ *
+ */
+bool Solver::isFixed()
+{
+    return _fixed;
 }
 
 /**
  * Solver::dumpSolutionStates
  *
  * Print solution states into log
+ * States are rebuilt from the start board by replaying solution shuffles
  * Just for debug
  *
  */
 void Solver::dumpSolutionStates()
 {
-    if ( Solver::_slnStates.begin() != Solver::_slnStates.end() )
+    int steps = _sln.stepsCnt;
+    if ( steps > 0 && steps <= (int)_sln.shuffles.size() )
     {
         char buf[8];
+        Board board = _board;
         Logger::getInstance().append("Solution states:").endl();
-        std::map<int, std::string>::iterator it;
-        for ( int i = 1; i <= Solver::_slnStepsCnt; i++ )
+        for ( int i = 0; i < steps; i++ )
         {
-            it = Solver::_slnStates.find(i);
-            if ( it != Solver::_slnStates.end() )
-            {
-                snprintf(buf, 8, "%3d: ", i);
-                Logger::getInstance().append(buf)
-                .append(Solver::_slnStates[i]).endl();
-            }
+            board.swap(_sln.shuffles[i], 0);
+            snprintf(buf, 8, "%3d: ", i + 1);
+            Logger::getInstance().append(buf)
+            .append(board.toString()).endl();
         }
     }
 }
@@ -108,14 +290,14 @@ void Solver::dumpSolutionStates()
  */
 void Solver::dumpSolutionShuffles()
 {
-    std::vector<int>::reverse_iterator sIt;
-    if ( Solver::_slnShuffles.rbegin() != Solver::_slnShuffles.rend() )
+    int steps = _sln.stepsCnt;
+    if ( steps > 0 && steps <= (int)_sln.shuffles.size() )
     {
         std::stringstream ss(std::stringstream::in | std::stringstream::out);
         Logger::getInstance().append("Solution shuffles  :").endl();
-        for ( sIt = Solver::_slnShuffles.rbegin(); sIt < Solver::_slnShuffles.rend(); sIt++ )
+        for ( int i = 0; i < steps; i++ )
         {
-            ss << (*sIt) << ",";
+            ss << _sln.shuffles[i] << ",";
         }
         int pos = ss.tellp();
         ss.seekp(pos - 1);
@@ -130,5 +312,5 @@ void Solver::dumpSolutionShuffles()
  */
 Solver::~Solver()
 {
-    __destroy();
+    // search contexts are released with arena
 }
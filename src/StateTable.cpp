@@ -0,0 +1,177 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "StateTable.h"
+#include "Logger.h"
+
+/**
+ * StateTable constructor
+ *
+ * Empty table, use StateTable::get
+ *
+ */
+StateTable::StateTable()
+{
+    _width = 0;
+    _height = 0;
+    _size = 0;
+    _tilesStates = 0;
+}
+
+/**
+ * StateTable::get
+ *
+ * Get costs of all states of board geometry for a goal (value => flat position)
+ * Table is built on first request and shared by all solvers with the same dimension and goal
+ *
+ * Return NULL if state space of board is too large
+ *
+ */
+const StateTable* StateTable::get(int width, int height, const int * const goal)
+{
+    static std::map<std::vector<int>, StateTable> tables;
+    static boost::mutex tablesMutex;
+
+    // critical section
+    boost::mutex::scoped_lock lock(tablesMutex);
+    std::vector<int> key;
+    key.push_back(width);
+    key.push_back(height);
+    key.insert(key.end(), goal, goal + width * height);
+    std::map<std::vector<int>, StateTable>::iterator it = tables.find(key);
+    if ( it != tables.end() )
+    {
+        return &it->second;
+    }
+
+    StateTable table;
+    if ( ! table.__build(width, height, goal) )
+    {
+        return NULL;
+    }
+    StateTable &shared = tables[key];
+    shared._width = table._width;
+    shared._height = table._height;
+    shared._size = table._size;
+    shared._tilesStates = table._tilesStates;
+    shared._costs.swap(table._costs);
+    return &shared;
+}
+
+/**
+ * StateTable::getWidth
+ *
+ */
+int StateTable::getWidth() const
+{
+    return _width;
+}
+
+/**
+ * StateTable::getHeight
+ *
+ */
+int StateTable::getHeight() const
+{
+    return _height;
+}
+
+/**
+ * StateTable::__build
+ *
+ * Breadth-first search from a goal state over all reachable states
+ * States in queue are packed like cells of Board (PACKED_CELL_BITS per cell), cost of state is known when it is queued
+ *
+ */
+bool StateTable::__build(int width, int height, const int * const goal)
+{
+    int size = width * height;
+    uint64_t states = 0;
+    if ( size > 1 && size <= PACKED_SIZE_MAX )
+    {
+        states = size;
+        for ( int k = 2; k < size && states <= 2 * STATE_TABLE_STATES_MAX; k++ )
+            states *= k;
+        states /= 2;
+    }
+    if ( ! states || states > STATE_TABLE_STATES_MAX )
+    {
+        Logger::getInstance().errorAt("StateTable::__build")
+        .explain("state space of board is too large ")
+        .append(width).append("x").append(height).endl();
+        return false;
+    }
+
+    _width = width;
+    _height = height;
+    _size = size;
+    _tilesStates = states / size;
+    _costs.assign(states, STATE_TABLE_COST_UNKNOWN);
+    const MoveTable *moveTable = Board::getMoveTable(width, height);
+
+    std::vector<uint64_t> queue(states);
+    uint64_t packed = 0;
+    int cells[PACKED_SIZE_MAX];
+    for ( int value = 0; value < size; value++ )
+    {
+        cells[goal[value]] = value;
+        packed |= (uint64_t)value << (goal[value] * PACKED_CELL_BITS);
+    }
+    _costs[rank(cells)] = 0;
+    queue[0] = packed;
+
+    size_t head = 0;
+    size_t tail = 1;
+    while ( head < tail )
+    {
+        packed = queue[head++];
+        int blank = 0;
+        for ( int pos = 0; pos < size; pos++ )
+        {
+            cells[pos] = (packed >> (pos * PACKED_CELL_BITS)) & PACKED_CELL_MASK;
+            if ( ! cells[pos] )
+                blank = pos;
+        }
+        int cost = _costs[rank(cells)];
+
+        const int *moves = &moveTable->moves[blank * NEIGHBOURS_CNT_MAX];
+        for ( int i = 0; i < moveTable->movesCnt[blank]; i++ )
+        {
+            int pos = moves[i];
+            int value = cells[pos];
+            cells[blank] = value;
+            cells[pos] = 0;
+            uint32_t r = rank(cells);
+            if ( _costs[r] == STATE_TABLE_COST_UNKNOWN )
+            {
+                _costs[r] = cost + 1;
+                queue[tail++] = (packed & ~(PACKED_CELL_MASK << (pos * PACKED_CELL_BITS)))
+                              | ((uint64_t)value << (blank * PACKED_CELL_BITS));
+            }
+            cells[pos] = value;
+            cells[blank] = 0;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "Table_Descent.h"
+#include "Logger.h"
+#include <limits>
+
+/**
+ * Table_Descent constructor
+ *
+ */
+Table_Descent::Table_Descent(Board &board) : Solver(board)
+{
+    // Initialized in a base class
+    strcpy(_algName, "Table descent");
+}
+
+/**
+ * Table_Descent::solve
+ *
+ * Each step moves empty cell to a neighbour, which is one move closer to a goal
+ * Exact costs of all states are taken from a table (built on first solve of board geometry)
+ *
+ * Return minimal count of moves needed for solution (0 if board is too large for state table)
+ *
+ */
+int Table_Descent::solve()
+{
+    if ( ! _board.isNotNull() )
+    {
+        return 0;
+    }
+    __resetSolution();
+
+    Logger::getInstance().append(_algName).append(" started, ").timestamp();
+
+    __mStart();
+
+    int size = _board.getSize();
+    int goal[size];
+    getGoal(goal);
+    const StateTable *table = StateTable::get(_board.getWidth(), _board.getHeight(), goal);
+    if ( ! table )
+    {
+        __mStop();
+        Logger::getInstance().errorAt("Table_Descent::solve")
+        .explain("board is too large for state table ")
+        .append(_board.getWidth()).append("x").append(_board.getHeight())
+        .append(" (more than ").append(STATE_TABLE_STATES_MAX).append(" states)").endl();
+        return 0;
+    }
+    int cells[size];
+    for ( int pos = 0; pos < size; pos++ )
+    {
+        cells[pos] = _board.getCell(pos);
+    }
+    int blank = _board.getBlank();
+    const MoveTable *moveTable = Board::getMoveTable(_board.getWidth(), _board.getHeight());
+    int H = table->getCost(cells);
+    for ( int G = 1; G <= H; G++ )
+    {
+        const int *moves = &moveTable->moves[blank * NEIGHBOURS_CNT_MAX];
+        for ( int i = 0; i < moveTable->movesCnt[blank]; i++ )
+        {
+            int pos = moves[i];
+            int nbr = cells[pos];
+            cells[blank] = nbr;
+            cells[pos] = 0;
+            _madeStepsCnt++;
+            if ( table->getCost(cells) == H - G )
+            {
+                _path[G] = nbr;
+                blank = pos;
+                break;
+            }
+            cells[pos] = nbr;
+            cells[blank] = 0;
+        }
+    }
+    __saveSolution(H);
+
+    __mStop();
+
+    Logger::getInstance().append(_algName).append(" stopped, ").timestamp();
+    Logger::getInstance().append("-----------------------").endl();
+    Logger::getInstance().append("Minimal steps count: ")
+    .append(_sln.stepsCnt.load()).endl();
+    Logger::getInstance().append("Made permutations  : ")
+    .append(this->_madeStepsCnt).endl();
+    char buf[128];
+    snprintf(buf, 128, "Solution time      : %.6f sec", __getSlnUsec()/1000000);
+    Logger::getInstance().append(buf).append(" (");
+    __getSlnTime(buf);
+    Logger::getInstance().append(buf).append(")").endl();
+    return _sln.stepsCnt;
+}
+
+/**
+ * Table_Descent destructor
+ *
+ */
+Table_Descent::~Table_Descent()
+{
+}
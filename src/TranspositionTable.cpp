@@ -0,0 +1,90 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "TranspositionTable.h"
+
+/**
+ * TranspositionTable constructor
+ *
+ */
+TranspositionTable::TranspositionTable(int mb)
+{
+    _entries = NULL;
+    _mask = 0;
+    if ( mb <= 0 )
+    {
+        return;
+    }
+
+    uint64_t size = 1;
+    while ( (size << 1) * sizeof(Entry) <= ((uint64_t)mb << 20) )
+    {
+        size <<= 1;
+    }
+    _entries = new Entry[size];
+    _mask = size - 1;
+    clear();
+}
+
+/**
+ * TranspositionTable::isNotNull
+ *
+ */
+bool TranspositionTable::isNotNull()
+{
+    return _entries != NULL;
+}
+
+/**
+ * TranspositionTable::getSize
+ *
+ */
+size_t TranspositionTable::getSize()
+{
+    return _entries ? _mask + 1 : 0;
+}
+
+/**
+ * TranspositionTable::clear
+ *
+ * Should be called before search, when no workers use table
+ *
+ */
+void TranspositionTable::clear()
+{
+    for ( uint64_t i = 0; _entries && i <= _mask; i++ )
+    {
+        _entries[i].check.store(0, std::memory_order_relaxed);
+        _entries[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * TranspositionTable destructor
+ *
+ */
+TranspositionTable::~TranspositionTable()
+{
+    delete[] _entries;
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "WalkingDistance.h"
+
+/**
+ * WalkingDistance constructor
+ *
+ * Tables are empty until build is called
+ *
+ */
+WalkingDistance::WalkingDistance(int width, int height)
+{
+    _width = width;
+    _height = height;
+    _rows = &_tables[0];
+    _cols = ( width == height ) ? &_tables[0] : &_tables[1];
+}
+
+/**
+ * WalkingDistance::isNotNull
+ *
+ * Check if tables were built
+ *
+ */
+bool WalkingDistance::isNotNull()
+{
+    return _rows->costs.size() && _cols->costs.size();
+}
+
+/**
+ * WalkingDistance::getWidth
+ *
+ */
+int WalkingDistance::getWidth()
+{
+    return _width;
+}
+
+/**
+ * WalkingDistance::getHeight
+ *
+ */
+int WalkingDistance::getHeight()
+{
+    return _height;
+}
+
+/**
+ * WalkingDistance::build
+ *
+ * Build tables for goal (value => flat position)
+ * Packed state (lines x lines counters) should fit into 64 bits, so boards up to 4x4
+ *
+ */
+bool WalkingDistance::build(const int * const goal)
+{
+    _goal.assign(goal, goal + _width * _height);
+
+    // table depends only on count of lines and line of empty cell in a goal state,
+    // so square board with empty cell on a diagonal uses one table
+    _cols = ( _width == _height && __goalLine(true, 0) == __goalLine(false, 0) ) ? _rows : &_tables[1];
+    if ( ! __buildTable(*_rows, true) )
+    {
+        return false;
+    }
+    return _cols == _rows || __buildTable(*_cols, false);
+}
+
+/**
+ * WalkingDistance::getIndex
+ *
+ * State of rows (columns) table for tiles positions (tilePos is value => flat position)
+ *
+ * Return -1 if tables weren't built
+ *
+ */
+int WalkingDistance::getIndex(bool rows, const int * const tilePos)
+{
+    const Table *t = rows ? _rows : _cols;
+    if ( ! isNotNull() )
+    {
+        return -1;
+    }
+    uint64_t key = 0;
+    for ( int value = 1; value < _width * _height; value++ )
+    {
+        int line = rows ? tilePos[value] / _width : tilePos[value] % _width;
+        key += 1ULL << ((line * t->lines + __goalLine(rows, value)) * t->bits);
+    }
+    std::unordered_map<uint64_t, int>::const_iterator it = t->indexes.find(key);
+    return it == t->indexes.end() ? -1 : it->second;
+}
+
+/**
+ * WalkingDistance::__goalLine
+ *
+ * Goal row (column) of tile
+ *
+ */
+int WalkingDistance::__goalLine(bool rows, int value)
+{
+    return rows ? _goal[value] / _width : _goal[value] % _width;
+}
+
+/**
+ * WalkingDistance::__buildTable
+ *
+ * Breadth-first search from a goal state (moves are reversible, so it gives cost to a goal)
+ * State is packed into 64 bits: counter of tiles in line l with goal line g
+ * takes bits from (l * lines + g) * bits, line of empty cell is the one with lineLen - 1 tiles
+ *
+ */
+bool WalkingDistance::__buildTable(Table &table, bool rows)
+{
+    table.lines = rows ? _height : _width;
+    table.lineLen = rows ? _width : _height;
+    table.bits = 1;
+    while ( (1 << table.bits) <= table.lineLen )
+        table.bits++;
+    int lines = table.lines;
+    int bits = table.bits;
+    uint64_t mask = (1ULL << bits) - 1;
+    if ( lines * lines * bits > WD_KEY_BITS_MAX )
+    {
+        Logger::getInstance().errorAt("WalkingDistance::__buildTable")
+        .explain("walking distance is not supported for ")
+        .append(_width).append("x").append(_height).append(" board").endl();
+        return false;
+    }
+
+    // goal state
+    uint64_t key = 0;
+    for ( int value = 1; value < _width * _height; value++ )
+    {
+        int g = __goalLine(rows, value);
+        key += 1ULL << ((g * lines + g) * bits);
+    }
+    table.indexes.clear();
+    table.costs.clear();
+    std::vector<uint64_t> keys;
+    table.indexes[key] = 0;
+    table.costs.push_back(0);
+    keys.push_back(key);
+    table.next.assign(2 * lines, -1);
+
+    // states are indexed in order of discovery, so keys is a queue
+    for ( unsigned int index = 0; index < keys.size(); index++ )
+    {
+        uint64_t state = keys[index];
+        int blank = 0;
+        for ( int l = 0; l < lines; l++ )
+        {
+            int cnt = 0;
+            for ( int g = 0; g < lines; g++ )
+                cnt += (state >> ((l * lines + g) * bits)) & mask;
+            if ( cnt < table.lineLen )
+            {
+                blank = l;
+            }
+        }
+        for ( int dir = WD_UP; dir <= WD_DOWN; dir++ )
+        {
+            int from = ( dir == WD_UP ) ? blank - 1 : blank + 1;
+            if ( from < 0 || from >= lines )
+            {
+                continue;
+            }
+            for ( int g = 0; g < lines; g++ )
+            {
+                if ( ! ((state >> ((from * lines + g) * bits)) & mask) )
+                {
+                    continue;
+                }
+
+                // tile with goal line g moves from line of new empty cell into line of old one
+                uint64_t moved = state - (1ULL << ((from * lines + g) * bits))
+                                 + (1ULL << ((blank * lines + g) * bits));
+                std::unordered_map<uint64_t, int>::const_iterator it = table.indexes.find(moved);
+                int next = 0;
+                if ( it == table.indexes.end() )
+                {
+                    next = keys.size();
+                    if ( next >= WD_STATES_MAX || table.costs[index] + 1 >= 0xFF )
+                    {
+                        Logger::getInstance().errorAt("WalkingDistance::__buildTable")
+                        .explain("too many states").endl();
+                        return false;
+                    }
+                    table.indexes[moved] = next;
+                    table.costs.push_back(table.costs[index] + 1);
+                    table.next.resize((next + 1) * 2 * lines, -1);
+                    keys.push_back(moved);
+                }
+                else
+                {
+                    next = it->second;
+                }
+                table.next[(index * 2 + dir) * lines + g] = next;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,18 @@
+# Batch mode test: solvable, unsolvable (odd permutation) and invalid puzzles of tests/batch.txt
+# Run by CTest: cmake -DPUZZLE=<15puzzle> -DINPUT=<batch.txt> -P batch.cmake
+
+execute_process(COMMAND ${PUZZLE} --batch ${INPUT}
+                RESULT_VARIABLE result
+                OUTPUT_VARIABLE output)
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "batch exited with ${result}:\n${output}")
+endif()
+
+foreach(expected
+	"{\"id\":0,\"status\":\"solved\",\"steps\":31,\"moves\":\\[[0-9,]+\\],"
+	"{\"id\":1,\"status\":\"unsolvable\",\"steps\":null,\"moves\":null}\n"
+	"{\"id\":2,\"status\":\"error\",\"error\":\"[^\"]+\"}\n")
+	if(NOT output MATCHES "${expected}")
+		message(FATAL_ERROR "batch output doesn't match ${expected}:\n${output}")
+	endif()
+endforeach()
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2012 The Fifteen Puzzle Project, <blackchval@gmail.com>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+
+ * THIS SOFTWARE IS PROVIDED BY THE FIFTEEN PUZZLE PROJECT AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE FIFTEEN PUZZLE PROJECT OR CONTRIBUTORS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Fifteen_API test, run by CTest
+ *
+ * Solution of README example is replayed to a goal, error statuses are checked
+ * Return 0 if all checks passed
+ *
+ */
+
+#include "Fifteen_API.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int failed = 0;
+
+/**
+ * Report failed check
+ *
+ */
+static void check(int ok, const char *what)
+{
+    if ( ! ok )
+    {
+        fprintf(stderr, "FAILED: %s\n", what);
+        failed++;
+    }
+}
+
+/**
+ * Apply moves (tiles moved into empty cell) to tiles of width x height board
+ *
+ * Return 1 if each move is made by a neighbour of empty cell and a goal is reached
+ *
+ */
+static int replay(int *tiles, int width, int height, const int *moves, int movesCnt)
+{
+    int size = width * height;
+    int blank = 0;
+    while ( tiles[blank] )
+    {
+        blank++;
+    }
+    for ( int i = 0; i < movesCnt; i++ )
+    {
+        int pos = 0;
+        while ( pos < size && tiles[pos] != moves[i] )
+        {
+            pos++;
+        }
+        if ( pos == size || abs(pos / width - blank / width) + abs(pos % width - blank % width) != 1 )
+        {
+            return 0;
+        }
+        tiles[blank] = tiles[pos];
+        tiles[pos] = 0;
+        blank = pos;
+    }
+    for ( int i = 0; i < size - 1; i++ )
+    {
+        if ( tiles[i] != i + 1 )
+        {
+            return 0;
+        }
+    }
+    return ! tiles[size - 1];
+}
+
+int main()
+{
+    int tiles[9] = {8,6,7, 2,5,4, 3,0,1};
+    int unsolvable[9] = {1,2,3, 4,5,6, 8,7,0};
+    int moves[64];
+    fifteen_options options;
+    fifteen_result result;
+
+    // README example
+    int status = fifteen_solve(tiles, 3, 3, NULL, moves, 64, &result);
+    check(status == FIFTEEN_OK && result.status == FIFTEEN_OK, "example is solved");
+    check(result.stepsCnt == 31, "example is solved in 31 steps");
+    check(status == FIFTEEN_OK && replay(tiles, 3, 3, moves, result.stepsCnt), "moves lead to goal");
+
+    // tiles were changed by replay
+    int example[9] = {8,6,7, 2,5,4, 3,0,1};
+    fifteen_default_options(&options);
+    status = fifteen_solve(example, 3, 3, &options, moves, 2, &result);
+    check(status == FIFTEEN_BUFFER_TOO_SMALL, "short buffer is reported");
+    check(result.stepsCnt == 31, "steps count is set for short buffer");
+
+    status = fifteen_solve(unsolvable, 3, 3, &options, moves, 64, &result);
+    check(status == FIFTEEN_UNSOLVABLE, "odd permutation is unsolvable");
+
+    options.size = sizeof(options) - 1;
+    status = fifteen_solve(example, 3, 3, &options, moves, 64, &result);
+    check(status == FIFTEEN_BAD_OPTIONS, "options of unknown size are rejected");
+
+    return failed ? 1 : 0;
+}